@@ -97,6 +97,16 @@ public:
             "4. Focuses on corner and edge control\n"
             "5. Response time: Slower but thorough\n"
             "\n"
+            "Hard+ Level:\n"
+            "1. AI thinks 9 moves ahead\n"
+            "2. Uses the neural network evaluation when installed\n"
+            "3. For players who beat Hard regularly\n"
+            "\n"
+            "MCTS Level:\n"
+            "1. Monte Carlo tree search using every CPU core\n"
+            "2. Plays thousands of random games per move\n"
+            "3. Response time: about one second\n"
+            "\n"
             "AI Strategy Features:\n"
             "1. Uses minimax algorithm with alpha-beta pruning\n"
             "2. Evaluates board positions based on:\n"
@@ -115,6 +125,15 @@ public:
             "\n"
             "Select your preferred difficulty below:";
 
+        // Only 8x8 has the neural network and MCTS
+        if (BOARDLENGTH != 8) {
+            difficultyInfo.insert(difficultyInfo.find("AI Strategy Features:"),
+                "On the " + std::to_string(BOARDLENGTH) + "x" + std::to_string(BOARDLENGTH) + " board:\n"
+                "1. Hard+ searches with the handcrafted evaluation, there is no neural network\n"
+                "2. MCTS plays as Hard+\n"
+                "\n");
+        }
+
         textBox.setText(difficultyInfo, 14);
         textBox.setBackgroundColor(sf::Color(255, 255, 255, 128));
         textBox.setTextColor(sf::Color::Black);
@@ -122,11 +141,17 @@ public:
         sf::Vector2f buttonSize(200.0f, 50.0f);
         float startY = WINDOW_HEIGHT / 2.0f + 120.0f;
         float spacing = 60.0f;
+        // 第一列三個、第二列兩個按鈕，才放得下所有難度
+        float leftX = WINDOW_WIDTH / 2.0f - buttonSize.x * 1.5f - 20.0f;
+        float centerX = WINDOW_WIDTH / 2.0f - buttonSize.x / 2.0f;
+        float rightX = WINDOW_WIDTH / 2.0f + buttonSize.x / 2.0f + 20.0f;
+        float secondRowLeftX = WINDOW_WIDTH / 2.0f - buttonSize.x - 10.0f;
+        float secondRowRightX = WINDOW_WIDTH / 2.0f + 10.0f;
 
         // 水墨風格配色
         difficultyButtons.emplace_back(
             buttonSize,
-            sf::Vector2f(WINDOW_WIDTH / 2.0f - buttonSize.x / 2.0f, startY),
+            sf::Vector2f(leftX, startY),
             resources->getFont("main"),
             "Easy",
             sf::Color(120, 160, 140),    // 青竹綠
@@ -138,7 +163,7 @@ public:
 
         difficultyButtons.emplace_back(
             buttonSize,
-            sf::Vector2f(WINDOW_WIDTH / 2.0f - buttonSize.x / 2.0f, startY + spacing),
+            sf::Vector2f(centerX, startY),
             resources->getFont("main"),
             "Medium",
             sf::Color(140, 120, 160),    // 淡紫灰
@@ -150,7 +175,7 @@ public:
 
         difficultyButtons.emplace_back(
             buttonSize,
-            sf::Vector2f(WINDOW_WIDTH / 2.0f - buttonSize.x / 2.0f, startY + spacing * 2),
+            sf::Vector2f(rightX, startY),
             resources->getFont("main"),
             "Hard",
             sf::Color(160, 100, 90),     // 赤褐色
@@ -160,6 +185,30 @@ public:
             15.0f
         );
 
+        difficultyButtons.emplace_back(
+            buttonSize,
+            sf::Vector2f(secondRowLeftX, startY + spacing),
+            resources->getFont("main"),
+            "Hard+",
+            sf::Color(110, 70, 70),      // 深赭色
+            sf::Color(130, 90, 90),      // 懸停深赭色
+            sf::Color(90, 50, 50),       // 按下深赭色
+            resources->getSoundBuffer("click"),
+            15.0f
+        );
+
+        difficultyButtons.emplace_back(
+            buttonSize,
+            sf::Vector2f(secondRowRightX, startY + spacing),
+            resources->getFont("main"),
+            "MCTS",
+            sf::Color(90, 110, 150),     // 靛青色
+            sf::Color(110, 130, 170),    // 懸停靛青色
+            sf::Color(70, 90, 130),      // 按下靛青色
+            resources->getSoundBuffer("click"),
+            15.0f
+        );
+
         startTransitionIn();
     }
 
@@ -185,6 +234,8 @@ public:
                                 case 0: selectedDifficulty = AILevel::EASY; break;
                                 case 1: selectedDifficulty = AILevel::MEDIUM; break;
                                 case 2: selectedDifficulty = AILevel::HARD; break;
+                                case 3: selectedDifficulty = AILevel::HARD_PLUS; break;
+                                case 4: selectedDifficulty = AILevel::MCTS; break;
                                 default: ;
                             }
                             startGameWithDifficulty();
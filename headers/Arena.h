@@ -0,0 +1,103 @@
+//
+// Arena.h - bump arena and fixed object pool for search memory, with peak usage statistics
+//
+
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+
+/**
+ * Single-owner bump allocator over one fixed block. Allocation is a pointer
+ * increment, nothing is freed individually and reset() releases everything
+ * at once, so searches reset it at the start instead of using new/vector.
+ */
+class Arena {
+public:
+    explicit Arena(size_t bytes);
+
+    Arena(const Arena &) = delete;
+
+    Arena &operator=(const Arena &) = delete;
+
+    // `bytes` aligned to `alignment` (a power of two), or nullptr when the arena is full
+    void *allocate(size_t bytes, size_t alignment = alignof(std::max_align_t));
+
+    // Uninitialised array of trivially destructible objects, or nullptr when full
+    template<typename T>
+    T *allocateArray(const size_t count) {
+        static_assert(std::is_trivially_destructible<T>::value, "arena memory is never destroyed");
+        return static_cast<T *>(allocate(count * sizeof(T), alignof(T)));
+    }
+
+    // Release every allocation
+    void reset();
+
+    size_t getUsed() const { return used; }
+
+    // Most bytes in use at once since construction
+    size_t getPeak() const { return std::max(peak, used); }
+
+    size_t getCapacity() const { return capacity; }
+
+private:
+    std::unique_ptr<unsigned char[]> block;
+    size_t capacity;
+    size_t used = 0;
+    size_t peak = 0;
+};
+
+/**
+ * Fixed-capacity pool of T handing out contiguous blocks by index. Allocation
+ * is one atomic add, so many threads can share a pool without a lock; memory
+ * comes back only through reset(). Indices stay valid until then.
+ */
+template<typename T>
+class ObjectPool {
+public:
+    explicit ObjectPool(const size_t capacity) : objects(std::make_unique<T[]>(capacity)), capacity(capacity) {
+    }
+
+    ObjectPool(const ObjectPool &) = delete;
+
+    ObjectPool &operator=(const ObjectPool &) = delete;
+
+    // Index of `count` unused objects in a row, or -1 when the pool is exhausted
+    int32_t allocate(const int count) {
+        const size_t first = used.fetch_add(count, std::memory_order_relaxed);
+        if (first + count > capacity) {
+            return -1;
+        }
+        return static_cast<int32_t>(first);
+    }
+
+    T &operator[](const size_t index) { return objects[index]; }
+
+    const T &operator[](const size_t index) const { return objects[index]; }
+
+    // Forget every object; not safe while other threads allocate
+    void reset() {
+        peak = getPeak();
+        used.store(0, std::memory_order_relaxed);
+    }
+
+    size_t getUsed() const { return std::min(used.load(std::memory_order_relaxed), capacity); }
+
+    // Most objects in use at once since construction
+    size_t getPeak() const { return std::max(peak, getUsed()); }
+
+    size_t getCapacity() const { return capacity; }
+
+private:
+    std::unique_ptr<T[]> objects;
+    size_t capacity;
+    std::atomic<size_t> used{0};
+    size_t peak = 0;
+};
+
+#endif //ARENA_H
@@ -0,0 +1,46 @@
+//
+// BatchPlayout.h - random playouts of several games at once in SIMD lanes
+//
+
+#ifndef BATCHPLAYOUT_H
+#define BATCHPLAYOUT_H
+
+#include <cstdint>
+
+#include "../headers/Bitboard.h"
+
+/**
+ * Playout policy shared by every path: a uniformly random legal move, except
+ * that a corner is always taken when one is available.
+ *
+ * On CPUs with AVX2 and BMI2 four games advance in lockstep, one per 64-bit
+ * lane: move generation and flips run on all lanes at once, the random move of
+ * each lane is picked with popcount and pdep, and a lane whose game ends is
+ * refilled with the next start position. Elsewhere the games are played one
+ * by one.
+ */
+namespace BatchPlayout {
+    constexpr int LANES = 4;
+
+    // xorshift64*, the generator used by all playouts; `state` must not be 0
+    inline uint64_t nextRandom(uint64_t &state) {
+        state ^= state >> 12;
+        state ^= state << 25;
+        state ^= state >> 27;
+        return state * 0x2545F4914F6CDD1DULL;
+    }
+
+    /**
+     * Play one game from `pos` to the end.
+     * @return final disc difference for the side to move in `pos`
+     */
+    int single(Position pos, uint64_t &rng);
+
+    /**
+     * Play every position of `starts` to the end.
+     * results[i] receives the final disc difference for the side to move in starts[i].
+     */
+    void run(const Position *starts, int count, int *results, uint64_t &rng);
+}
+
+#endif //BATCHPLAYOUT_H
@@ -0,0 +1,185 @@
+//
+// Bitboard.h - 64-bit board representation used by the search
+//
+// Square index is y * 8 + x, so bit 0 is the top-left cell (a1) and
+// bit 63 the bottom-right cell (h8), matching board[y][x].
+//
+
+#ifndef BITBOARD_H
+#define BITBOARD_H
+
+#include <cstdint>
+#include <string>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+// A position seen from the side to move
+struct Position {
+    uint64_t player;    // discs of the side to move
+    uint64_t opponent;  // discs of the other side
+
+    bool operator==(const Position &other) const {
+        return player == other.player && opponent == other.opponent;
+    }
+};
+
+namespace Bitboard {
+    // The bitboard engine is 8x8 only; GenericBoard covers the other sizes
+    constexpr int SIZE = 8;
+
+    constexpr int PASS = 64;
+
+    constexpr uint64_t CORNERS = 0x8100000000000081ULL;
+    constexpr uint64_t EDGES = 0xFF818181818181FFULL;
+
+    inline int popcount(const uint64_t bits) {
+#ifdef _MSC_VER
+        return static_cast<int>(__popcnt64(bits));
+#else
+        return __builtin_popcountll(bits);
+#endif
+    }
+
+    // Index of the lowest set bit, bits must not be 0
+    inline int lowestSquare(const uint64_t bits) {
+#ifdef _MSC_VER
+        unsigned long index;
+        _BitScanForward64(&index, bits);
+        return static_cast<int>(index);
+#else
+        return __builtin_ctzll(bits);
+#endif
+    }
+
+    inline uint64_t squareBit(const int square) {
+        return 1ULL << square;
+    }
+
+    /**
+     * All legal moves for `player`.
+     * Each direction is flood-filled through opponent discs; the A/H file
+     * masks stop horizontal and diagonal rays from wrapping around rows.
+     */
+    inline uint64_t getMoves(const uint64_t player, const uint64_t opponent) {
+        const uint64_t inner = opponent & 0x7E7E7E7E7E7E7E7EULL;
+        const uint64_t empty = ~(player | opponent);
+        uint64_t moves = 0;
+
+        // Shift left/right by 1 (horizontal), 8 (vertical), 7 and 9 (diagonals)
+        const int shifts[4] = {1, 8, 7, 9};
+        const uint64_t masks[4] = {inner, opponent, inner, inner};
+
+        for (int i = 0; i < 4; i++) {
+            const int s = shifts[i];
+            const uint64_t mask = masks[i];
+
+            uint64_t flood = mask & (player << s);
+            flood |= mask & (flood << s);
+            flood |= mask & (flood << s);
+            flood |= mask & (flood << s);
+            flood |= mask & (flood << s);
+            flood |= mask & (flood << s);
+            moves |= flood << s;
+
+            flood = mask & (player >> s);
+            flood |= mask & (flood >> s);
+            flood |= mask & (flood >> s);
+            flood |= mask & (flood >> s);
+            flood |= mask & (flood >> s);
+            flood |= mask & (flood >> s);
+            moves |= flood >> s;
+        }
+
+        return moves & empty;
+    }
+
+    // Discs flipped when `player` plays on `square` (0 if the move is illegal)
+    inline uint64_t getFlips(const uint64_t player, const uint64_t opponent, const int square) {
+        const uint64_t inner = opponent & 0x7E7E7E7E7E7E7E7EULL;
+        const uint64_t move = squareBit(square);
+        uint64_t flips = 0;
+
+        const int shifts[4] = {1, 8, 7, 9};
+        const uint64_t masks[4] = {inner, opponent, inner, inner};
+
+        for (int i = 0; i < 4; i++) {
+            const int s = shifts[i];
+            const uint64_t mask = masks[i];
+
+            uint64_t line = 0;
+            uint64_t cell = (move << s) & mask;
+            while (cell) {
+                line |= cell;
+                cell <<= s;
+                if (cell & player) {
+                    flips |= line;
+                    break;
+                }
+                cell &= mask;
+            }
+
+            line = 0;
+            cell = (move >> s) & mask;
+            while (cell) {
+                line |= cell;
+                cell >>= s;
+                if (cell & player) {
+                    flips |= line;
+                    break;
+                }
+                cell &= mask;
+            }
+        }
+
+        return flips;
+    }
+
+    // Play `square` with precomputed flips; the result is seen from the new side to move
+    inline Position play(const Position &pos, const int square, const uint64_t flips) {
+        return {pos.opponent ^ flips, pos.player ^ flips ^ squareBit(square)};
+    }
+
+    inline Position pass(const Position &pos) {
+        return {pos.opponent, pos.player};
+    }
+
+    inline int empties(const Position &pos) {
+        return 64 - popcount(pos.player | pos.opponent);
+    }
+
+    // Bijective 64-bit finalizer: every input bit reaches every output bit
+    inline uint64_t mix(uint64_t x) {
+        x ^= x >> 30;
+        x *= 0xBF58476D1CE4E5B9ULL;
+        x ^= x >> 27;
+        x *= 0x94D049BB133111EBULL;
+        return x ^ (x >> 31);
+    }
+
+    /**
+     * 64-bit mix of both masks, used as transposition table key. Each mask
+     * goes through the full finalizer; a product alone only carries upward,
+     * so positions differing in the high squares collided.
+     */
+    inline uint64_t hash(const Position &pos) {
+        return mix(pos.player ^ mix(pos.opponent + 0x632BE59BD9B4E019ULL));
+    }
+
+    // Standard starting position, black to move
+    Position initial();
+
+    // Convert from/to the char board ('b', 'w', 's', 'a') used by the game screens
+    Position fromBoard(const char board[SIZE][SIZE], bool isWhiteTurn);
+
+    void toBoard(const Position &pos, bool isWhiteTurn, char board[SIZE][SIZE]);
+
+    // "a1".."h8" (column letter, row number), "pass" for PASS
+    std::string squareName(int square);
+
+    // Inverse of squareName, accepts upper case; returns -1 when invalid
+    int parseSquare(const std::string &name);
+}
+
+#endif //BITBOARD_H
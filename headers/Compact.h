@@ -0,0 +1,88 @@
+//
+// Compact.h - binary encodings of positions and games shared by saves, network and tools
+//
+
+#ifndef COMPACT_H
+#define COMPACT_H
+
+#include <array>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "../headers/Bitboard.h"
+
+/**
+ * A position is two little-endian bit masks, black then white, bit
+ * y * size + x for each cell: 16 bytes on 8x8. The four centre cells are
+ * never empty in a game from the standard start, so the white mask does not
+ * need the bit of its first centre cell (d4 on 8x8): its colour follows from
+ * the black mask, and the bit holds the side to move instead.
+ *
+ * A game is one byte per move, the cell index, with forced passes left out
+ * as in transcripts. Where a text line carries either of them (saves, the
+ * network protocol) the bytes are written in unpadded base64url.
+ */
+namespace Compact {
+    constexpr size_t POSITION_BYTES = 16;
+
+    using PackedPosition = std::array<uint8_t, POSITION_BYTES>;
+
+    // Bytes of a packed board of side `size`
+    constexpr size_t boardBytes(const int size) {
+        return 2 * static_cast<size_t>((size * size + 7) / 8);
+    }
+
+    // Cell whose white bit holds the side to move
+    constexpr int sideCell(const int size) {
+        return (size / 2 - 1) * size + size / 2 - 1;
+    }
+
+    // @return false, leaving `out` unchanged, when d4 is empty
+    bool pack(const Position &pos, bool whiteToMove, PackedPosition &out);
+
+    // @return false when both masks claim a cell
+    bool unpack(const PackedPosition &packed, Position &pos, bool &whiteToMove);
+
+    /**
+     * The same encoding for the char boards of the game screens ('b', 'w',
+     * anything else empty) of any size.
+     * @return the packed bytes, empty when the centre cell holding the side to move is empty
+     */
+    std::string packBoard(const char *cells, int size, bool whiteToMove);
+
+    /**
+     * Fill `cells` with 'b', 'w' and 's'.
+     * @return false, leaving `cells` unchanged, when `packed` is not a board of this size
+     */
+    bool unpackBoard(const std::string &packed, char *cells, int size, bool &whiteToMove);
+
+    // One byte per move
+    std::string packMoves(const std::vector<int> &moves);
+
+    // @return false when a byte is not a cell of a board with `cellCount` cells
+    bool unpackMoves(const std::string &packed, int cellCount, std::vector<int> &moves);
+
+    // Unpadded base64url, safe in text lines and protocol messages
+    std::string toText(const std::string &bytes);
+
+    // @return false when `text` has a character outside base64url or a bad length
+    bool fromText(const std::string &text, std::string &bytes);
+
+    // Game files: 8-byte magic, then every game as a count byte and its moves
+    constexpr char GAMES_MAGIC[8] = {'R', 'V', 'G', 'A', 'M', 'E', '0', '1'};
+
+    void writeGamesHeader(std::ostream &out);
+
+    // @return false when `in` does not start with GAMES_MAGIC; nothing is consumed then
+    bool readGamesHeader(std::istream &in);
+
+    void writeGame(std::ostream &out, const std::vector<int> &moves);
+
+    // @return false at the end of the file or on a truncated or damaged game
+    bool readGame(std::istream &in, std::vector<int> &moves);
+}
+
+#endif //COMPACT_H
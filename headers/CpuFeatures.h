@@ -0,0 +1,49 @@
+//
+// CpuFeatures.h - runtime checks for the instruction sets of the SIMD kernels
+//
+
+#ifndef CPUFEATURES_H
+#define CPUFEATURES_H
+
+#if defined(REVERSI_AVX2) && defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#include <immintrin.h>
+#endif
+
+/**
+ * The engine is built for plain x86-64. Functions marked REVERSI_TARGET_AVX2
+ * are compiled for AVX2 and BMI2 on their own and may only be called when
+ * CpuFeatures::avx2() is true; everything else runs on any CPU.
+ */
+#if defined(REVERSI_AVX2) && !(defined(_MSC_VER) && !defined(__clang__))
+#define REVERSI_TARGET_AVX2 __attribute__((target("avx2,bmi2")))
+#else
+// MSVC compiles AVX2 intrinsics without an architecture flag
+#define REVERSI_TARGET_AVX2
+#endif
+
+namespace CpuFeatures {
+    // True when the kernels were built and this CPU and OS run AVX2 and BMI2
+    inline bool avx2() {
+#if !defined(REVERSI_AVX2)
+        return false;
+#elif defined(_MSC_VER) && !defined(__clang__)
+        static const bool supported = []() {
+            int info[4];
+            __cpuid(info, 1);
+            // The OS must save the YMM registers
+            if (!(info[2] & (1 << 27)) || (_xgetbv(0) & 6) != 6) {
+                return false;
+            }
+            __cpuidex(info, 7, 0);
+            return (info[1] & (1 << 5)) != 0 && (info[1] & (1 << 8)) != 0;
+        }();
+        return supported;
+#else
+        static const bool supported = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("bmi2");
+        return supported;
+#endif
+    }
+}
+
+#endif //CPUFEATURES_H
@@ -0,0 +1,97 @@
+//
+// EndgameCache.h - persistent memory-mapped table of exactly solved endgame positions
+//
+
+#ifndef ENDGAMECACHE_H
+#define ENDGAMECACHE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "../headers/Bitboard.h"
+
+/**
+ * Open-addressing hash table of exact endgame results, living in a file that
+ * is memory-mapped by every process using it. Positions are stored in their
+ * canonical symmetry, so a result proven once serves all eight variants.
+ *
+ * Slots are written without locks: each carries a check word over its
+ * contents, and a slot torn by a concurrent writer fails the check and reads
+ * as empty. The table never grows; when the probe window of a position is full
+ * the entry with the fewest empties (the cheapest to solve again) is replaced.
+ */
+class EndgameCache {
+public:
+    // Smaller endgames are solved faster than they are looked up
+    static constexpr int MIN_EMPTIES = 14;
+
+    static constexpr size_t DEFAULT_MEGABYTES = 64;
+
+    EndgameCache() = default;
+
+    ~EndgameCache();
+
+    EndgameCache(const EndgameCache &) = delete;
+
+    EndgameCache &operator=(const EndgameCache &) = delete;
+
+    /**
+     * Map the cache file at `path`, creating it with about `megabytes` of slots
+     * when it does not exist. A new file gets its header under a temporary name
+     * before it appears, so other processes never see it half set up. An
+     * existing file keeps its own size; one written by an older version is
+     * emptied in place.
+     * @return false when the file cannot be created, mapped or is not a cache file
+     */
+    bool open(const std::string &path, size_t megabytes = DEFAULT_MEGABYTES);
+
+    void close();
+
+    bool isOpen() const { return slots != nullptr; }
+
+    /**
+     * Look up `pos`.
+     * @param score receives the final disc difference for the side to move
+     * @param bestMove receives the best move in `pos` coordinates, may be nullptr
+     */
+    bool probe(const Position &pos, int &score, int *bestMove = nullptr) const;
+
+    // Record the exact result of `pos`; positions under MIN_EMPTIES are ignored
+    void store(const Position &pos, int score, int bestMove);
+
+    size_t getSlotCount() const { return slotCount; }
+
+private:
+    enum class MapResult {
+        MAPPED,
+        MISSING,
+        SETTING_UP,     // the header is not written yet, try again
+        FAILED
+    };
+
+    // Create the file with its header and zeroed slots; false only when it can't be written
+    static bool createFile(const std::string &path, size_t count);
+
+    MapResult mapFile(const std::string &path);
+
+    struct Slot {
+        std::atomic<uint64_t> player;
+        std::atomic<uint64_t> opponent;
+        std::atomic<uint64_t> data;     // score, best move and empties
+        std::atomic<uint64_t> check;    // player ^ opponent ^ data ^ CHECK_SALT
+    };
+
+    void *mapping = nullptr;
+    size_t mappedBytes = 0;
+    Slot *slots = nullptr;
+    size_t slotCount = 0;
+
+#ifdef _WIN32
+    void *fileHandle = nullptr;
+    void *mapHandle = nullptr;
+#endif
+};
+
+#endif //ENDGAMECACHE_H
@@ -0,0 +1,140 @@
+//
+// Evaluation.h - static evaluation used at the search horizon
+//
+
+#ifndef EVALUATION_H
+#define EVALUATION_H
+
+#include <algorithm>
+#include <array>
+#include <string>
+
+#include "../headers/Bitboard.h"
+
+namespace Evaluation {
+    constexpr int CORNER_BONUS = 10;
+    constexpr int EDGE_BONUS = 2;
+
+    // Evaluations stay below Search::FINAL_SCALE so they never look like finished games
+    constexpr int MAX_EVAL = 999;
+
+    // Squares alike under the eight board symmetries: corner, C, A, B, X and the inner squares
+    constexpr int SQUARE_CLASSES = 10;
+
+    // Weighted features: every disc, corners, other edge cells, then one per square class
+    enum Feature {
+        DISC,
+        CORNER,
+        EDGE,
+        SQUARE_CLASS,
+        FEATURES = SQUARE_CLASS + SQUARE_CLASSES
+    };
+
+    // Where the game looks for tuned weights, relative to the executable's working directory
+    constexpr const char *DEFAULT_PATH = "./weights/reversi.eval";
+
+    /**
+     * Class of the cell (x, y) of a size x size board: its distances from the
+     * nearest two edges, smaller first, numbered row by row. On 10x10 the
+     * cells further in than the 8x8 centre share its class.
+     */
+    constexpr int squareClass(const int x, const int y, const int size) {
+        const int a = std::min(3, std::min(std::min(x, size - 1 - x), std::min(y, size - 1 - y)));
+        const int b = std::min(3, std::max(std::min(x, size - 1 - x), std::min(y, size - 1 - y)));
+
+        // (0,0) (0,1) (0,2) (0,3) (1,1) (1,2) (1,3) (2,2) (2,3) (3,3)
+        constexpr int FIRST[4] = {0, 4, 7, 9};
+        return FIRST[a] + b - a;
+    }
+
+    constexpr int squareClass(const int square) {
+        return squareClass(square % 8, square / 8, 8);
+    }
+
+    constexpr uint64_t featureMask(const int feature) {
+        if (feature == DISC) {
+            return ~0ULL;
+        }
+        if (feature == CORNER) {
+            return Bitboard::CORNERS;
+        }
+        if (feature == EDGE) {
+            return Bitboard::EDGES & ~Bitboard::CORNERS;
+        }
+
+        uint64_t mask = 0;
+        for (int square = 0; square < 64; square++) {
+            if (squareClass(square) == feature - SQUARE_CLASS) {
+                mask |= 1ULL << square;
+            }
+        }
+        return mask;
+    }
+
+    constexpr std::array<uint64_t, FEATURES> makeFeatureMasks() {
+        std::array<uint64_t, FEATURES> masks{};
+        for (int feature = 0; feature < FEATURES; feature++) {
+            masks[feature] = featureMask(feature);
+        }
+        return masks;
+    }
+
+    // featureMask of every feature, built at compile time so evaluation never loops over the squares
+    inline constexpr std::array<uint64_t, FEATURES> FEATURE_MASKS = makeFeatureMasks();
+
+    /**
+     * Weight of every feature in evaluation units. The defaults are the
+     * untuned evaluation: every disc counts 1, corners add CORNER_BONUS and
+     * other edge cells add EDGE_BONUS.
+     */
+    struct Weights {
+        int values[FEATURES] = {1, CORNER_BONUS, EDGE_BONUS};
+    };
+
+    // Disc difference of the side to move on every feature mask
+    inline void features(const Position &pos, int out[FEATURES]) {
+        for (int feature = 0; feature < FEATURES; feature++) {
+            const uint64_t mask = FEATURE_MASKS[feature];
+            out[feature] = Bitboard::popcount(pos.player & mask) - Bitboard::popcount(pos.opponent & mask);
+        }
+    }
+
+    // Score of `pos` for the side to move
+    inline int evaluate(const Position &pos, const Weights &weights) {
+        int score = 0;
+        for (int feature = 0; feature < FEATURES; feature++) {
+            if (weights.values[feature]) {
+                const uint64_t mask = FEATURE_MASKS[feature];
+                score += weights.values[feature]
+                        * (Bitboard::popcount(pos.player & mask) - Bitboard::popcount(pos.opponent & mask));
+            }
+        }
+        return std::clamp(score, -MAX_EVAL, MAX_EVAL);
+    }
+
+    /**
+     * Read a weights file: one "name value" line per feature (disc, corner,
+     * edge, square0 .. square9), '#' starts a comment. Features left out keep
+     * their value in `weights`.
+     * @return false when the file is missing or has an unknown name or unreadable value
+     */
+    bool load(const std::string &path, Weights &weights);
+
+    bool save(const std::string &path, const Weights &weights);
+
+    // Name of a feature in weights files
+    std::string featureName(int feature);
+
+    /**
+     * Weights loaded from DEFAULT_PATH on first use and shared by every search,
+     * the defaults when no weights file is installed.
+     */
+    const Weights &shared();
+
+    // Score of `pos` for the side to move with the shared weights
+    inline int evaluate(const Position &pos) {
+        return evaluate(pos, shared());
+    }
+}
+
+#endif //EVALUATION_H
@@ -9,16 +9,51 @@
 #include <vector>
 #include <iostream>
 #include <fstream>
+#include <memory>
+#include <random>
 
-#define BOARDLENGTH 8
+#include "../headers/GenericBoard.h"
+#include "../headers/TimeManager.h"
+
+// Board side length, chosen at build time (6, 8 or 10); only 8x8 has the neural network and MCTS
+#ifndef REVERSI_BOARD_SIZE
+#define REVERSI_BOARD_SIZE 8
+#endif
+
+constexpr int BOARDLENGTH = REVERSI_BOARD_SIZE;
+
+// One bit per cell, bit y * BOARDLENGTH + x
+using BoardMask = BoardGeometry<BOARDLENGTH>::Mask;
+
+static_assert(BOARDLENGTH == 6 || BOARDLENGTH == 8 || BOARDLENGTH == 10, "supported board sizes are 6, 8 and 10");
 
 using namespace std;
 
+class MonteCarloSearch;
+
+template<int N>
+class GenericSearch;
+
 // AI difficulty levels
 enum class AILevel {
-    EASY,   // 3 moves ahead
-    MEDIUM, // 5 moves ahead
-    HARD    // 7 moves ahead
+    EASY,   // 3 moves ahead, small node budget, noisy and blunders now and then
+    MEDIUM, // 5 moves ahead, small node budget, slightly noisy
+    HARD,   // 7 moves ahead
+    HARD_PLUS, // 9 moves ahead, neural evaluation when weights are installed
+    MCTS    // Monte Carlo tree search on every core, fixed time per move
+};
+
+/**
+ * How a search level plays. The node budget bounds the cost of every move,
+ * so a level is as fast in a wide open midgame as in a quiet one; strength
+ * below the top levels comes from the noise and the blunders rather than
+ * from a shallower search alone.
+ */
+struct AIProfile {
+    int maxDepth;           // plies, the AI's own move included
+    uint64_t nodeBudget;    // nodes per move, 0 for no limit
+    int noise;              // standard deviation added to the root move scores, in evaluation units
+    double blunderChance;   // chance of playing a random legal move other than the best
 };
 
 class FundamentalFunction {
@@ -26,6 +61,8 @@ public:
 
     FundamentalFunction();
 
+    ~FundamentalFunction();
+
     char board[BOARDLENGTH][BOARDLENGTH]{};
 
     char** getBoard() {
@@ -39,8 +76,39 @@ public:
     // Show all place that user can take
     void showPlayPlace(bool);
 
-    // Consider whether the step is available.
-    void dedect(int xPos, int yPos, int moveX, int moveY, bool isWhiteTurn);
+    // Remove the marks left by showPlayPlace()
+    void clearPlayPlace();
+
+    /**
+     * Legal moves of one side. Computed once per position version and side,
+     * so asking again before the discs change costs nothing.
+     */
+    BoardMask legalMoves(bool isWhiteTurn);
+
+    bool hasMoves(const bool isWhiteTurn) { return static_cast<bool>(legalMoves(isWhiteTurn)); }
+
+    // The side cannot move but its opponent can, so the turn passes
+    bool mustPass(const bool isWhiteTurn) { return !hasMoves(isWhiteTurn) && hasMoves(!isWhiteTurn); }
+
+    // Neither side can move
+    bool isGameOver() { return !hasMoves(false) && !hasMoves(true); }
+
+    /**
+     * Call after writing `board` directly (loading, copying, restoring); the
+     * discs are counted again. initialize() and turnOver() keep the version
+     * and the counts themselves.
+     */
+    void boardChanged();
+
+    // Disc counts, updated from the flips of every move
+    int getBlackCount() const { return blackCount; }
+
+    int getWhiteCount() const { return whiteCount; }
+
+    int getEmptyCount() const { return BOARDLENGTH * BOARDLENGTH - blackCount - whiteCount; }
+
+    // Changes whenever the discs on the board change
+    uint64_t getVersion() const { return version; }
 
     // output the checkerboard in current time.
     void display() const;
@@ -53,25 +121,61 @@ public:
 
     std::pair<int, int> AIPlayChess();
 
+    /**
+     * AI move on the game clock: the search stops within the time the
+     * TimeManager gives this move, and a forced move is played at once.
+     * @param remainingSeconds time left on the AI's clock for this move
+     * @param remainingChances timeouts the AI can still afford
+     */
+    std::pair<int, int> AIPlayChess(double remainingSeconds, int remainingChances);
+
     // AI difficulty functions
     void setAIDifficulty(AILevel level);
     AILevel getAIDifficulty() const { return aiDifficulty; }
 
+    // Replay the same evaluation noise and blunders; seeded from the OS otherwise
+    void setRandomSeed(unsigned seed) { aiRandom.seed(seed); }
+
 private:
     int targetX{};
     int targetY{};
     AILevel aiDifficulty;
 
-    // AI helper functions
-    std::pair<int, int> getEasyAIMove(const std::vector<std::pair<int, int>>& availableMoves);
-    std::pair<int, int> getMediumAIMove(const std::vector<std::pair<int, int>>& availableMoves);
-    std::pair<int, int> getHardAIMove(const std::vector<std::pair<int, int>>& availableMoves);
+    // Legal moves of black [0] and white [1], valid while their version is current
+    struct MoveCache {
+        uint64_t version = UINT64_MAX;
+        BoardMask moves{};
+    };
+
+    uint64_t version = 0;
+    MoveCache moveCache[2];
+
+    int blackCount = 0;
+    int whiteCount = 0;
+
+    // Squares marked 'a' on the board; unknown after a direct write until the next full clear
+    BoardMask markedMoves{};
+    bool markersKnown = false;
+
+    // Created on the first AI move so boards that never ask the AI carry no hash table
+    std::unique_ptr<GenericSearch<BOARDLENGTH> > search;
+
+    // Kept between moves so the tree below the current position is reused
+    std::unique_ptr<MonteCarloSearch> monteCarlo;
+
+    // Thinking time of the MCTS level
+    static constexpr double MCTS_SECONDS_PER_MOVE = 1.0;
+
+    // Draws the evaluation noise and the blunders
+    std::mt19937 aiRandom{std::random_device{}()};
+
+    static const AIProfile &profile(AILevel level);
+
+    // True when this move should be a blunder
+    bool blunders(const AIProfile &level);
 
-    int minimax(int depth, bool isMaximizing, int alpha, int beta);
-    int evaluateBoard();
-    void copyBoard(char dest[BOARDLENGTH][BOARDLENGTH], const char src[BOARDLENGTH][BOARDLENGTH]);
-    void makeMove(int x, int y, bool isWhite);
-    std::vector<std::pair<int, int>> getValidMoves(bool isWhiteTurn);
+    // Move of the AI (white) within `budget`, the level's depth still caps the search
+    std::pair<int, int> chooseMove(const TimeBudget &budget);
 };
 
 #endif //FUNDAMENTALFUNCTION_H
\ No newline at end of file
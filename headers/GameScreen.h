@@ -16,6 +16,8 @@
 #include "../headers/Global.h"
 #include "../headers/Timer.h"
 #include "../headers/SaveGame.h"
+#include "../headers/HintAnalyzer.h"
+#include "../headers/MoveTree.h"
 
 // 前向宣告
 class MainMenu;
@@ -28,6 +30,9 @@ private:
     float aiThinkingTime = 0.0f;
     bool aiThinking = false;
 
+    // Seconds of the last AI search, already charged to the AI's clock and left out of the next frame
+    float pendingSearchTime = 0.0f;
+
     sf::Sprite backgroundSprite;
     sf::Text titleText;
     sf::Text player1Text;
@@ -48,8 +53,11 @@ private:
 
     // Buttons
     Button undoButton;
+    Button redoButton;
+    Button lineButton;
     Button menuButton;
     Button saveButton;
+    Button hintButton;
 
     // Game state
     std::string player1Name;
@@ -68,19 +76,29 @@ private:
     int selectedX;
     int selectedY;
 
-    // Move history for undo
-    struct Move {
-        int x;
-        int y;
-        bool wasWhiteTurn;
+    // Whole game state after a move, so undo and redo are a copy instead of a replay
+    struct Snapshot {
+        char board[BOARDLENGTH][BOARDLENGTH];   // including the move markers of the side to move
+        bool isWhiteTurn;
+        int player1Score;
+        int player2Score;
+        bool gameOver;
     };
 
-    std::vector<Move> moveHistory;
+    // Every move tried in this game; the current node is the position on the board
+    MoveTree<Snapshot> moveTree;
+
+    // Move made since the last snapshot, x is -1 when there is none
+    struct PlayedMove {
+        int x = -1;
+        int y = -1;
+        bool byWhite = false;
+    } playedMove;
 
     // Constants for board rendering
     const float cellSize = 50.0f;
-    const float boardX = (WINDOW_WIDTH - 8 * cellSize) / 2.0f;
-    const float boardY = (WINDOW_HEIGHT - 8 * cellSize) / 2.0f + 20.0f;
+    const float boardX = (WINDOW_WIDTH - BOARDLENGTH * cellSize) / 2.0f;
+    const float boardY = (WINDOW_HEIGHT - BOARDLENGTH * cellSize) / 2.0f + 20.0f;
 
     sf::Sound placeSound;
     // 添加AI 難度相關成員
@@ -94,6 +112,16 @@ private:
     sf::RectangleShape timerBackground1;
     sf::RectangleShape timerBackground2;
 
+    // Move-hint overlay: scores of every available move, refined in the background
+    static constexpr int HINT_MAX_DEPTH = 14;
+    bool showHints = false;
+    HintAnalyzer hintAnalyzer;
+    AnalysisInfo hintInfo;
+    unsigned hintVersion = 0;
+    bool hintRunning = false;
+    HintAnalyzer::Pos hintPosition{};
+    std::vector<sf::Text> hintTexts;
+
     static void drawRoundedRectangle(sf::RenderWindow &window, const sf::Vector2f &position,
                              const sf::Vector2f &size, const sf::Color &color, float radius) {
         // 與Button.h中相同的圓角矩形繪製函數
@@ -164,7 +192,7 @@ public:
           timerLabel2(sf::Text(resources->getFont("main"))),
           undoButton(
               sf::Vector2f(100.0f, 40.0f),
-              sf::Vector2f(WINDOW_WIDTH - 130.0f, WINDOW_HEIGHT - 70.0f),
+              sf::Vector2f(WINDOW_WIDTH - 250.0f, WINDOW_HEIGHT - 70.0f),
               resources->getFont("main"),
               "Undo",
               sf::Color(180, 120, 60),
@@ -173,6 +201,28 @@ public:
               resources->getSoundBuffer("click"),
               15.0f
           ),
+          redoButton(
+              sf::Vector2f(100.0f, 40.0f),
+              sf::Vector2f(WINDOW_WIDTH - 130.0f, WINDOW_HEIGHT - 70.0f),
+              resources->getFont("main"),
+              "Redo",
+              sf::Color(180, 120, 60),
+              sf::Color(200, 140, 80),
+              sf::Color(160, 100, 40),
+              resources->getSoundBuffer("click"),
+              15.0f
+          ),
+          lineButton(
+              sf::Vector2f(100.0f, 40.0f),
+              sf::Vector2f(WINDOW_WIDTH - 490.0f, WINDOW_HEIGHT - 70.0f),
+              resources->getFont("main"),
+              "Line 1/1",
+              sf::Color(180, 120, 60),
+              sf::Color(200, 140, 80),
+              sf::Color(160, 100, 40),
+              resources->getSoundBuffer("click"),
+              15.0f
+          ),
           menuButton(
               sf::Vector2f(100.0f, 40.0f),
               sf::Vector2f(30.0f, WINDOW_HEIGHT - 70.0f),
@@ -195,6 +245,17 @@ public:
               resources->getSoundBuffer("click"),
               15.0f
           ),
+          hintButton(
+              sf::Vector2f(100.0f, 40.0f),
+              sf::Vector2f(WINDOW_WIDTH - 370.0f, WINDOW_HEIGHT - 70.0f),
+              resources->getFont("main"),
+              "Hint",
+              sf::Color(120, 140, 170),
+              sf::Color(140, 160, 190),
+              sf::Color(100, 120, 150),
+              resources->getSoundBuffer("click"),
+              15.0f
+          ),
           player1Name(std::move(p1Name)),
           player2Name(std::move(p2Name)),
           vsComputer(vsAI),
@@ -215,7 +276,7 @@ public:
 
     void setAIDifficulty(AILevel level);
 
-    void setLoadedGameData(const FundamentalFunction &, bool, int, int);
+    void setLoadedGameData(const FundamentalFunction &, bool, int, int, const std::string &moveTreeText = "");
 
     void handleInput(sf::Event event) override;
 
@@ -235,12 +296,46 @@ public:
 
     void checkTimers();
 
+    // Step back one move, or against the computer back to the last position where the human was to move
     void undoMove();
 
+    // Step forward again along the line last visited
+    void redoMove();
+
+    // Switch to the next variation of the last move (the last human move against the computer)
+    void nextLine();
+
+    // Node whose alternatives the Line button cycles through
+    int variationNode() const;
+
+    // Show which of the alternatives of the last move is on the board
+    void updateLineButton();
+
+    // Add the played move and the state after it to the move tree, or refresh the current node
+    void recordSnapshot();
+
+    // Put the position of tree node `index` on the board
+    void restoreSnapshot(int index);
+
+    // Current board, turn, scores and game-over flag
+    Snapshot takeSnapshot() const;
+
+    /**
+     * State after `byWhite` plays (x, y) in `from`, with the turn passed back
+     * when the next player has no move.
+     * @return false when the move is not legal there
+     */
+    static bool playSnapshot(const Snapshot &from, int x, int y, bool byWhite, Snapshot &to);
+
     void saveCurrentGame();
 
     void makeAIMove();
 
+    // Restart the hint analysis when the position or turn changed
+    void refreshHints();
+
+    // Rebuild the score labels from the latest analysis
+    void updateHintTexts();
 
 };
 
@@ -0,0 +1,337 @@
+//
+// GenericBoard.h - bitboards and move generation for any supported board size
+//
+// Square index is y * N + x as on the 8x8 board. Boards up to 8x8 fit one
+// 64-bit word, 10x10 uses the 128-bit Bits128. The 8x8 instantiation forwards
+// to the hand-tuned Bitboard functions, so it costs nothing over them.
+//
+
+#ifndef GENERICBOARD_H
+#define GENERICBOARD_H
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+#include "../headers/Bitboard.h"
+#include "../headers/Evaluation.h"
+
+// Two 64-bit words acting as one 128-bit mask
+struct Bits128 {
+    uint64_t low = 0;
+    uint64_t high = 0;
+
+    constexpr Bits128() = default;
+
+    constexpr Bits128(const uint64_t low, const uint64_t high = 0) : low(low), high(high) {
+    }
+
+    constexpr Bits128 operator&(const Bits128 &other) const { return {low & other.low, high & other.high}; }
+
+    constexpr Bits128 operator|(const Bits128 &other) const { return {low | other.low, high | other.high}; }
+
+    constexpr Bits128 operator^(const Bits128 &other) const { return {low ^ other.low, high ^ other.high}; }
+
+    constexpr Bits128 operator~() const { return {~low, ~high}; }
+
+    constexpr Bits128 operator<<(const int shift) const {
+        if (shift == 0) {
+            return *this;
+        }
+        if (shift >= 64) {
+            return {0, low << (shift - 64)};
+        }
+        return {low << shift, high << shift | low >> (64 - shift)};
+    }
+
+    constexpr Bits128 operator>>(const int shift) const {
+        if (shift == 0) {
+            return *this;
+        }
+        if (shift >= 64) {
+            return {high >> (shift - 64), 0};
+        }
+        return {low >> shift | high << (64 - shift), high >> shift};
+    }
+
+    Bits128 &operator&=(const Bits128 &other) { return *this = *this & other; }
+
+    Bits128 &operator|=(const Bits128 &other) { return *this = *this | other; }
+
+    Bits128 &operator^=(const Bits128 &other) { return *this = *this ^ other; }
+
+    constexpr bool operator==(const Bits128 &other) const { return low == other.low && high == other.high; }
+
+    constexpr bool operator!=(const Bits128 &other) const { return !(*this == other); }
+
+    constexpr explicit operator bool() const { return low || high; }
+};
+
+// Word helpers shared by both mask types
+namespace BoardBits {
+    inline int popcount(const uint64_t bits) { return Bitboard::popcount(bits); }
+
+    inline int popcount(const Bits128 &bits) {
+        return Bitboard::popcount(bits.low) + Bitboard::popcount(bits.high);
+    }
+
+    // Index of the lowest set bit, bits must not be empty
+    inline int lowestSquare(const uint64_t bits) { return Bitboard::lowestSquare(bits); }
+
+    inline int lowestSquare(const Bits128 &bits) {
+        return bits.low ? Bitboard::lowestSquare(bits.low) : 64 + Bitboard::lowestSquare(bits.high);
+    }
+
+    inline uint64_t withoutLowest(const uint64_t bits) { return bits & (bits - 1); }
+
+    inline Bits128 withoutLowest(const Bits128 &bits) {
+        return bits.low ? Bits128{bits.low & (bits.low - 1), bits.high} : Bits128{0, bits.high & (bits.high - 1)};
+    }
+
+    // Transposition table key of a position, Bitboard::hash when both masks fit one word
+    inline uint64_t hash(const uint64_t player, const uint64_t opponent) {
+        return Bitboard::hash({player, opponent});
+    }
+
+    inline uint64_t hash(const Bits128 &player, const Bits128 &opponent) {
+        return Bitboard::hash({player.low, opponent.low})
+               ^ Bitboard::mix(Bitboard::hash({player.high, opponent.high}) + 0x9E3779B97F4A7C15ULL);
+    }
+}
+
+namespace BoardMasks {
+    template<typename Mask, int N, typename Predicate>
+    constexpr Mask select(Predicate predicate) {
+        Mask mask{};
+        for (int y = 0; y < N; y++) {
+            for (int x = 0; x < N; x++) {
+                if (predicate(x, y)) {
+                    mask = mask | Mask(1) << (y * N + x);
+                }
+            }
+        }
+        return mask;
+    }
+}
+
+/**
+ * Compile-time constants of an N x N board. Every mask is generated by a
+ * constexpr function, so each size gets its own tables with no runtime setup.
+ */
+template<int N>
+struct BoardGeometry {
+    static_assert(N == 6 || N == 8 || N == 10, "supported board sizes are 6, 8 and 10");
+
+    static constexpr int SIZE = N;
+    static constexpr int CELLS = N * N;
+    static constexpr int PASS = CELLS;
+
+    using Mask = std::conditional_t<(CELLS <= 64), uint64_t, Bits128>;
+
+    static constexpr Mask ALL = BoardMasks::select<Mask, N>([](int, int) { return true; });
+
+    // Columns 1 to N - 2: a ray shifted sideways through these never wraps to the next row
+    static constexpr Mask INNER_COLUMNS = BoardMasks::select<Mask, N>([](const int x, int) {
+        return x > 0 && x < N - 1;
+    });
+
+    static constexpr Mask CORNERS = BoardMasks::select<Mask, N>([](const int x, const int y) {
+        return (x == 0 || x == N - 1) && (y == 0 || y == N - 1);
+    });
+
+    static constexpr Mask EDGES = BoardMasks::select<Mask, N>([](const int x, const int y) {
+        return x == 0 || x == N - 1 || y == 0 || y == N - 1;
+    });
+
+    // Diagonal neighbours of the corners
+    static constexpr Mask X_SQUARES = BoardMasks::select<Mask, N>([](const int x, const int y) {
+        return (x == 1 || x == N - 2) && (y == 1 || y == N - 2);
+    });
+
+    // The four centre discs of the starting position
+    static constexpr Mask INITIAL_BLACK = BoardMasks::select<Mask, N>([](const int x, const int y) {
+        return (x == N / 2 && y == N / 2 - 1) || (x == N / 2 - 1 && y == N / 2);
+    });
+
+    static constexpr Mask INITIAL_WHITE = BoardMasks::select<Mask, N>([](const int x, const int y) {
+        return (x == N / 2 - 1 && y == N / 2 - 1) || (x == N / 2 && y == N / 2);
+    });
+
+    static Mask squareBit(const int square) { return Mask(1) << square; }
+};
+
+namespace BoardMasks {
+    // Mask of an Evaluation feature on an N x N board
+    template<int N>
+    constexpr typename BoardGeometry<N>::Mask feature(const int feature) {
+        using Geometry = BoardGeometry<N>;
+        if (feature == Evaluation::DISC) {
+            return Geometry::ALL;
+        }
+        if (feature == Evaluation::CORNER) {
+            return Geometry::CORNERS;
+        }
+        if (feature == Evaluation::EDGE) {
+            return Geometry::EDGES & ~Geometry::CORNERS;
+        }
+        return select<typename Geometry::Mask, N>([feature](const int x, const int y) {
+            return Evaluation::squareClass(x, y, N) == feature - Evaluation::SQUARE_CLASS;
+        });
+    }
+
+    template<int N>
+    constexpr std::array<typename BoardGeometry<N>::Mask, Evaluation::FEATURES> features() {
+        std::array<typename BoardGeometry<N>::Mask, Evaluation::FEATURES> masks{};
+        for (int index = 0; index < Evaluation::FEATURES; index++) {
+            masks[index] = feature<N>(index);
+        }
+        return masks;
+    }
+}
+
+// A position of an N x N board seen from the side to move
+template<int N>
+struct BoardPosition {
+    typename BoardGeometry<N>::Mask player;
+    typename BoardGeometry<N>::Mask opponent;
+
+    bool operator==(const BoardPosition &other) const {
+        return player == other.player && opponent == other.opponent;
+    }
+};
+
+// The 8x8 board uses Position itself, so Bitboard code takes its positions unchanged
+template<int N>
+using GenericPosition = std::conditional_t<N == 8, Position, BoardPosition<N> >;
+
+/**
+ * Move generation for an N x N board, the same flood fills as Bitboard with
+ * the shifts (1, N - 1, N, N + 1) and masks of the size.
+ */
+template<int N>
+struct GenericBoard {
+    using Geometry = BoardGeometry<N>;
+    using Mask = typename Geometry::Mask;
+    using Pos = GenericPosition<N>;
+
+    static Mask getMoves(const Mask player, const Mask opponent) {
+        const Mask inner = opponent & Geometry::INNER_COLUMNS;
+        const Mask empty = ~(player | opponent) & Geometry::ALL;
+        Mask moves{};
+
+        const int shifts[4] = {1, N, N - 1, N + 1};
+        const Mask masks[4] = {inner, opponent, inner, inner};
+
+        for (int i = 0; i < 4; i++) {
+            const int s = shifts[i];
+            const Mask mask = masks[i];
+
+            // At most N - 2 opponent discs lie between a move and the disc closing the line
+            Mask flood = mask & (player << s);
+            for (int step = 0; step < N - 3; step++) {
+                flood |= mask & (flood << s);
+            }
+            moves |= flood << s;
+
+            flood = mask & (player >> s);
+            for (int step = 0; step < N - 3; step++) {
+                flood |= mask & (flood >> s);
+            }
+            moves |= flood >> s;
+        }
+
+        return moves & empty;
+    }
+
+    // Discs flipped when `player` plays on `square` (empty if the move is illegal)
+    static Mask getFlips(const Mask player, const Mask opponent, const int square) {
+        const Mask inner = opponent & Geometry::INNER_COLUMNS;
+        const Mask move = Geometry::squareBit(square);
+        Mask flips{};
+
+        const int shifts[4] = {1, N, N - 1, N + 1};
+        const Mask masks[4] = {inner, opponent, inner, inner};
+
+        for (int i = 0; i < 4; i++) {
+            const int s = shifts[i];
+            const Mask mask = masks[i];
+
+            Mask line{};
+            Mask cell = (move << s) & mask;
+            while (cell) {
+                line |= cell;
+                cell = cell << s;
+                if (cell & player) {
+                    flips |= line;
+                    break;
+                }
+                cell &= mask;
+            }
+
+            line = Mask{};
+            cell = (move >> s) & mask;
+            while (cell) {
+                line |= cell;
+                cell = cell >> s;
+                if (cell & player) {
+                    flips |= line;
+                    break;
+                }
+                cell &= mask;
+            }
+        }
+
+        return flips;
+    }
+
+    static Pos play(const Pos &pos, const int square, const Mask flips) {
+        return {pos.opponent ^ flips, pos.player ^ flips ^ Geometry::squareBit(square)};
+    }
+
+    static Pos pass(const Pos &pos) {
+        return {pos.opponent, pos.player};
+    }
+
+    static int empties(const Pos &pos) {
+        return Geometry::CELLS - BoardBits::popcount(pos.player | pos.opponent);
+    }
+
+    // Standard starting position, black to move
+    static Pos initial() {
+        return {Geometry::INITIAL_BLACK, Geometry::INITIAL_WHITE};
+    }
+
+    // Convert from the char board ('b', 'w', 's', 'a') used by the game screens
+    static Pos fromBoard(const char board[N][N], const bool isWhiteTurn) {
+        Mask black{};
+        Mask white{};
+
+        for (int y = 0; y < N; y++) {
+            for (int x = 0; x < N; x++) {
+                if (board[y][x] == 'b') {
+                    black |= Geometry::squareBit(y * N + x);
+                } else if (board[y][x] == 'w') {
+                    white |= Geometry::squareBit(y * N + x);
+                }
+            }
+        }
+
+        return isWhiteTurn ? Pos{white, black} : Pos{black, white};
+    }
+};
+
+// The 8x8 board keeps the unrolled Bitboard code
+
+template<>
+inline uint64_t GenericBoard<8>::getMoves(const uint64_t player, const uint64_t opponent) {
+    return Bitboard::getMoves(player, opponent);
+}
+
+template<>
+inline uint64_t GenericBoard<8>::getFlips(const uint64_t player, const uint64_t opponent, const int square) {
+    return Bitboard::getFlips(player, opponent, square);
+}
+
+#endif //GENERICBOARD_H
@@ -0,0 +1,56 @@
+//
+// HintAnalyzer.h - background multi-PV analysis for the move-hint overlay
+//
+
+#ifndef HINTANALYZER_H
+#define HINTANALYZER_H
+
+#include <mutex>
+#include <thread>
+
+#include "../headers/FundamentalFunction.h"
+#include "../headers/Search.h"
+
+class HintAnalyzer {
+public:
+    using Pos = GenericBoard<BOARDLENGTH>::Pos;
+
+private:
+    GenericSearch<BOARDLENGTH> search;
+    std::thread worker;
+
+    mutable std::mutex mutex;
+    AnalysisInfo latest;
+    unsigned latestVersion = 0;
+
+public:
+    HintAnalyzer() : search(8) {
+    }
+
+    ~HintAnalyzer() {
+        stop();
+    }
+
+    HintAnalyzer(const HintAnalyzer &) = delete;
+
+    HintAnalyzer &operator=(const HintAnalyzer &) = delete;
+
+    /**
+     * Score every legal move of `pos` on a worker thread, deepening until
+     * `maxDepth`. Any analysis still running is cancelled first.
+     */
+    void start(const Pos &pos, int maxDepth);
+
+    // Cancel the running analysis and drop its results
+    void stop();
+
+    /**
+     * Copy the newest completed iteration into `info` if it changed since `version`.
+     * Never blocks on the search, so it is safe to call every frame.
+     *
+     * @return true when `info` and `version` were updated
+     */
+    bool poll(AnalysisInfo &info, unsigned &version) const;
+};
+
+#endif //HINTANALYZER_H
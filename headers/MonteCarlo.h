@@ -0,0 +1,106 @@
+//
+// MonteCarlo.h - multithreaded Monte Carlo tree search (UCT) over bitboards
+//
+
+#ifndef MONTECARLO_H
+#define MONTECARLO_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "../headers/Arena.h"
+#include "../headers/Bitboard.h"
+
+// Budget of one search; the first limit reached ends it
+struct MonteCarloLimits {
+    double seconds = 1.0;       // 0 for no time limit
+    uint64_t playouts = 0;      // 0 for no playout limit
+    int threads = 0;            // 0 for every core
+};
+
+class MonteCarloSearch {
+public:
+    // Default tree size, 32 bytes per node
+    static constexpr size_t DEFAULT_NODES = 1 << 20;
+
+    explicit MonteCarloSearch(size_t nodeCapacity = DEFAULT_NODES);
+
+    ~MonteCarloSearch();
+
+    MonteCarloSearch(const MonteCarloSearch &) = delete;
+
+    MonteCarloSearch &operator=(const MonteCarloSearch &) = delete;
+
+    /**
+     * Grow the tree from `pos` until a limit is reached and return the most
+     * visited move, or Bitboard::PASS when there is none.
+     * When `pos` is a child or grandchild of the previous root its subtree is kept.
+     */
+    int search(const Position &pos, const MonteCarloLimits &limits);
+
+    // Abort a running search from another thread; cleared by the next search()
+    void requestStop() { stopRequested.store(true, std::memory_order_relaxed); }
+
+    // Drop the whole tree
+    void clear();
+
+    // Playouts of the last search
+    uint64_t getPlayouts() const { return playouts; }
+
+    // Share of wins for the side to move at the root, from 0 to 1
+    double getRootWinRate() const;
+
+    // Nodes in use, including the kept subtree of earlier searches
+    size_t getNodesUsed() const { return nodes.getUsed(); }
+
+    // Most nodes ever in use at once
+    size_t getPeakNodes() const { return nodes.getPeak(); }
+
+private:
+    static constexpr int32_t NO_CHILDREN = -1;
+
+    // Longest root-to-leaf path: every move and pass of a game
+    static constexpr int MAX_PATH = 130;
+
+    enum : uint8_t { UNEXPANDED = 0, EXPANDING = 1, EXPANDED = 2 };
+
+    struct Node {
+        Position pos;                       // position after `move`, from the next mover's view
+        std::atomic<int32_t> visits{0};     // includes pending virtual losses
+        std::atomic<int32_t> wins{0};       // half points for the player who made `move`
+        int32_t firstChild = NO_CHILDREN;   // children are stored next to each other
+        uint8_t childCount = 0;
+        uint8_t move = Bitboard::PASS;
+        std::atomic<uint8_t> state{UNEXPANDED};
+    };
+
+    // Pick an unused block of `count` nodes; -1 when the pool is exhausted
+    int32_t allocate(int count);
+
+    // Create the children of `index`; false when another thread is doing it or the pool is full
+    bool expand(int32_t index);
+
+    // Child with the best UCT value, counting virtual losses
+    int32_t selectChild(const Node &node) const;
+
+    // Walk from the root to a leaf, expanding on the way and adding virtual losses; returns the path length
+    int descend(int32_t *path, bool &terminal);
+
+    // Remove the virtual losses along `path` and add the result of the leaf's side to move
+    void backup(const int32_t *path, int length, int result);
+
+    // One selection per playout lane, a batched playout of the leaves, then the backups
+    void iterate(uint64_t &rng, int32_t (*paths)[MAX_PATH]);
+
+    // Find `pos` within two plies of the current root
+    int32_t findReusable(const Position &pos) const;
+
+    ObjectPool<Node> nodes;
+    int32_t root = NO_CHILDREN;
+
+    std::atomic<bool> stopRequested{false};
+    std::atomic<uint64_t> playouts{0};
+};
+
+#endif //MONTECARLO_H
@@ -0,0 +1,200 @@
+//
+// MoveTree.h - game record with variations, every node keeping its position
+//
+
+#ifndef MOVETREE_H
+#define MOVETREE_H
+
+#include <functional>
+#include <istream>
+#include <ostream>
+#include <utility>
+#include <vector>
+
+/**
+ * Tree of the moves tried in a game. The root is the position the game
+ * started from and every other node is reached by one move from its parent.
+ * Each node holds the whole `State` after its move, so jumping to any node is
+ * a lookup instead of a replay. Nodes are never removed, so indices stay valid
+ * for the life of the tree.
+ *
+ * The first child of a node is its main line; playing a move that was already
+ * tried goes back into that variation instead of adding a copy.
+ */
+template<typename State>
+class MoveTree {
+public:
+    static constexpr int NONE = -1;
+
+    struct Node {
+        int parent = NONE;
+        int x = -1;                 // move leading here, -1 at the root
+        int y = -1;
+        bool byWhite = false;
+        int lastChild = NONE;       // child visited last, followed by redo
+        std::vector<int> children;  // main line first
+        State state;
+    };
+
+    explicit MoveTree(const State &root = State()) { reset(root); }
+
+    // Drop every move and start again from `root`
+    void reset(const State &root) {
+        nodes.clear();
+        nodes.push_back(Node());
+        nodes[0].state = root;
+        current = 0;
+    }
+
+    /**
+     * Play a move from the current node, which becomes its node.
+     * @return the node of the move, reused when it was already in the tree
+     */
+    int add(const int x, const int y, const bool byWhite, const State &state) {
+        for (const int child: nodes[current].children) {
+            if (nodes[child].x == x && nodes[child].y == y) {
+                nodes[child].state = state;
+                return enter(child);
+            }
+        }
+
+        Node node;
+        node.parent = current;
+        node.x = x;
+        node.y = y;
+        node.byWhite = byWhite;
+        node.state = state;
+        nodes.push_back(node);
+
+        const int index = static_cast<int>(nodes.size()) - 1;
+        nodes[current].children.push_back(index);
+        return enter(index);
+    }
+
+    // Make `index` the current node, remembering the way down from its parent
+    int enter(const int index) {
+        current = index;
+        if (nodes[index].parent != NONE) {
+            nodes[nodes[index].parent].lastChild = index;
+        }
+        return index;
+    }
+
+    // Replace the state of the current node when the position changed without a move
+    void setCurrentState(const State &state) { nodes[current].state = state; }
+
+    // Node redo goes to: the child visited last, otherwise the main line
+    int next(const int index) const {
+        const Node &node = nodes[index];
+        if (node.lastChild != NONE) {
+            return node.lastChild;
+        }
+        return node.children.empty() ? NONE : node.children.front();
+    }
+
+    // The following alternative to the move of `index`, wrapping around; `index` itself when there is none
+    int nextSibling(const int index) const {
+        const int parent = nodes[index].parent;
+        if (parent == NONE) {
+            return index;
+        }
+
+        const std::vector<int> &siblings = nodes[parent].children;
+        for (size_t i = 0; i < siblings.size(); i++) {
+            if (siblings[i] == index) {
+                return siblings[(i + 1) % siblings.size()];
+            }
+        }
+        return index;
+    }
+
+    // Index of `index` among the alternatives at its parent, 0 for the main line
+    int variation(const int index) const {
+        const int parent = nodes[index].parent;
+        if (parent == NONE) {
+            return 0;
+        }
+
+        const std::vector<int> &siblings = nodes[parent].children;
+        for (size_t i = 0; i < siblings.size(); i++) {
+            if (siblings[i] == index) {
+                return static_cast<int>(i);
+            }
+        }
+        return 0;
+    }
+
+    // Moves from the root to `index`
+    int depth(int index) const {
+        int plies = 0;
+        while (nodes[index].parent != NONE) {
+            index = nodes[index].parent;
+            plies++;
+        }
+        return plies;
+    }
+
+    const Node &operator[](const int index) const { return nodes[index]; }
+
+    const Node &getCurrentNode() const { return nodes[current]; }
+
+    int getCurrent() const { return current; }
+
+    int size() const { return static_cast<int>(nodes.size()); }
+
+    /**
+     * Write the shape of the tree as text: the node count and current node,
+     * then "parent x y byWhite" for every node after the root. States are not
+     * written; read() recomputes them.
+     */
+    void write(std::ostream &out) const {
+        out << nodes.size() << ' ' << current << '\n';
+        for (size_t i = 1; i < nodes.size(); i++) {
+            out << nodes[i].parent << ' ' << nodes[i].x << ' ' << nodes[i].y << ' ' << nodes[i].byWhite << '\n';
+        }
+    }
+
+    /**
+     * Rebuild a tree written by write() below `root`.
+     * @param play computes the state after a move from its parent state, false when the move is illegal
+     * @return false, leaving the tree unchanged, when the text is damaged or a move does not replay
+     */
+    bool read(std::istream &in, const State &root,
+              const std::function<bool(const State &, int, int, bool, State &)> &play) {
+        int count;
+        int currentNode;
+        if (!(in >> count >> currentNode) || count < 1 || currentNode < 0 || currentNode >= count) {
+            return false;
+        }
+
+        MoveTree tree(root);
+        for (int i = 1; i < count; i++) {
+            Node node;
+            int byWhite;
+            if (!(in >> node.parent >> node.x >> node.y >> byWhite) || node.parent < 0 || node.parent >= i) {
+                return false;
+            }
+            node.byWhite = byWhite != 0;
+            if (!play(tree.nodes[node.parent].state, node.x, node.y, node.byWhite, node.state)) {
+                return false;
+            }
+            tree.nodes[node.parent].children.push_back(i);
+            tree.nodes.push_back(node);
+        }
+
+        // Redo from any node on the way leads back to the saved position
+        for (int index = currentNode; tree.nodes[index].parent != NONE; index = tree.nodes[index].parent) {
+            tree.nodes[tree.nodes[index].parent].lastChild = index;
+        }
+        tree.current = currentNode;
+
+        *this = std::move(tree);
+        return true;
+    }
+
+private:
+    std::vector<Node> nodes;
+    int current = 0;
+};
+
+#endif //MOVETREE_H
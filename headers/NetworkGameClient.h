@@ -10,6 +10,7 @@
 #include "../headers/Global.h"
 #include "../headers/FundamentalFunction.h"
 #include "../headers/VictoryScreen.h"
+#include "../headers/Compact.h"
 #include <SFML/Graphics.hpp>
 #include <SFML/Network.hpp>
 #include <utility>
@@ -23,7 +24,7 @@ class MainMenu;
 
 class NetworkGameClient : public GameState {
 private:
-    static const int BOARD_SIZE = 8;
+    static const int BOARD_SIZE = BOARDLENGTH;
 
     // 網路相關
     sf::TcpSocket socket;
@@ -38,6 +39,7 @@ private:
 
     // 遊戲狀態和邏輯
     std::array<std::array<char, BOARD_SIZE>, BOARD_SIZE> board{};
+    std::atomic<bool> boardDirty{true}; // board 有新內容尚未複製到 gameLogic
     FundamentalFunction gameLogic;
     std::string gameStatus;
     std::string connectionStatus;
@@ -71,8 +73,8 @@ private:
 
     // 常量
     const float cellSize = 50.0f;
-    const float boardX = (WINDOW_WIDTH - 8 * cellSize) / 2.0f;
-    const float boardY = (WINDOW_HEIGHT - 8 * cellSize) / 2.0f + 50.0f;
+    const float boardX = (WINDOW_WIDTH - BOARD_SIZE * cellSize) / 2.0f;
+    const float boardY = (WINDOW_HEIGHT - BOARD_SIZE * cellSize) / 2.0f + 50.0f;
 
     int selectedX, selectedY;
 
@@ -171,7 +173,7 @@ public:
         scoreText.setPosition({WINDOW_WIDTH / 2.0f - 60.0f, 110.0f});
 
         // 設置遊戲板
-        boardBackground.setSize({cellSize * 8, cellSize * 8});
+        boardBackground.setSize({cellSize * BOARD_SIZE, cellSize * BOARD_SIZE});
         boardBackground.setPosition({boardX, boardY});
         boardBackground.setFillColor(sf::Color(240, 235, 220));
         boardBackground.setOutlineThickness(2.0f);
@@ -238,7 +240,7 @@ public:
         int boardCoordX = static_cast<int>((mousePos.x - boardX) / cellSize);
         int boardCoordY = static_cast<int>((mousePos.y - boardY) / cellSize);
 
-        if (boardCoordX >= 0 && boardCoordX < 8 && boardCoordY >= 0 && boardCoordY < 8) {
+        if (boardCoordX >= 0 && boardCoordX < BOARD_SIZE && boardCoordY >= 0 && boardCoordY < BOARD_SIZE) {
             selectedX = boardCoordX;
             selectedY = boardCoordY;
         } else {
@@ -251,16 +253,16 @@ public:
         window.draw(backgroundSprite);
         window.draw(boardBackground);
 
-        for (int i = 0; i <= 8; i++) {
+        for (int i = 0; i <= BOARD_SIZE; i++) {
             sf::Vertex hLine[] = {
                 sf::Vertex{{boardX, boardY + i * cellSize}, sf::Color(76, 76, 76)},
-                sf::Vertex{{boardX + 8 * cellSize, boardY + i * cellSize}, sf::Color(76, 76, 76)}
+                sf::Vertex{{boardX + BOARD_SIZE * cellSize, boardY + i * cellSize}, sf::Color(76, 76, 76)}
             };
             window.draw(hLine, 2, sf::PrimitiveType::Lines);
 
             sf::Vertex vLine[] = {
                 sf::Vertex{{boardX + i * cellSize, boardY}, sf::Color(76, 76, 76)},
-                sf::Vertex{{boardX + i * cellSize, boardY + 8 * cellSize}, sf::Color(76, 76, 76)}
+                sf::Vertex{{boardX + i * cellSize, boardY + BOARD_SIZE * cellSize}, sf::Color(76, 76, 76)}
             };
             window.draw(vLine, 2, sf::PrimitiveType::Lines);
         }
@@ -292,44 +294,51 @@ private:
             row.fill('s');
         }
 
-        board[3][3] = 'w';
-        board[3][4] = 'b';
-        board[4][3] = 'b';
-        board[4][4] = 'w';
+        const int center = BOARD_SIZE / 2;
+        board[center - 1][center - 1] = 'w';
+        board[center - 1][center] = 'b';
+        board[center][center - 1] = 'b';
+        board[center][center] = 'w';
 
-        for (int y = 0; y < 8; y++) {
-            for (int x = 0; x < 8; x++) {
+        for (int y = 0; y < BOARD_SIZE; y++) {
+            for (int x = 0; x < BOARD_SIZE; x++) {
                 gameLogic.board[y][x] = board[y][x];
             }
         }
+        gameLogic.boardChanged();
+        boardDirty = true;
     }
 
+    // Called every frame; only copies the board when the server sent a new one
     void updateAvailableMoves() {
-        if (!connected || gameOver) return;
-
-        for (int y = 0; y < 8; y++) {
-            for (int x = 0; x < 8; x++) {
-                if (board[y][x] == 'B') {
-                    gameLogic.board[y][x] = 'b';
-                } else if (board[y][x] == 'W') {
-                    gameLogic.board[y][x] = 'w';
-                } else {
-                    gameLogic.board[y][x] = 's';
+        if (boardDirty) {
+            for (int y = 0; y < BOARD_SIZE; y++) {
+                for (int x = 0; x < BOARD_SIZE; x++) {
+                    if (board[y][x] == 'B') {
+                        gameLogic.board[y][x] = 'b';
+                    } else if (board[y][x] == 'W') {
+                        gameLogic.board[y][x] = 'w';
+                    } else {
+                        gameLogic.board[y][x] = 's';
+                    }
                 }
             }
+            gameLogic.boardChanged();
+            boardDirty = false;
+
+            // Counted once by the game logic for each board the server sends
+            blackScore = gameLogic.getBlackCount();
+            whiteScore = gameLogic.getWhiteCount();
         }
 
+        if (!connected || gameOver) return;
+
+        // Both return at once while the position and turn are unchanged
         if (isMyTurn) {
             bool isWhiteTurn = (playerColor == "WHITE");
             gameLogic.showPlayPlace(isWhiteTurn);
         } else {
-            for (int y = 0; y < 8; y++) {
-                for (int x = 0; x < 8; x++) {
-                    if (gameLogic.board[y][x] == 'a') {
-                        gameLogic.board[y][x] = 's';
-                    }
-                }
-            }
+            gameLogic.clearPlayPlace();
         }
     }
 
@@ -445,6 +454,9 @@ private:
         else if (message.substr(0, 5) == "BOARD") {
             updateBoardFromServer(message.substr(6));
         }
+        else if (message.compare(0, 9, "POSITION:") == 0) {
+            updateBoardFromPacked(message.substr(9));
+        }
         else if (message == "YOUR_TURN") {
             isMyTurn = true;
             std::cout << "It's your turn!" << std::endl;
@@ -480,26 +492,36 @@ private:
     }
 
     void updateBoardFromServer(const std::string& boardData) {
-        if (boardData.length() != 64) {
+        if (boardData.length() != BOARD_SIZE * BOARD_SIZE) {
             std::cout << "Received invalid board data, length: " << boardData.length() << std::endl;
             return;
         }
 
         std::cout << "Updating board state from server" << std::endl;
 
-        for (int y = 0; y < 8; y++) {
-            for (int x = 0; x < 8; x++) {
-                board[y][x] = boardData[y * 8 + x];
+        for (int y = 0; y < BOARD_SIZE; y++) {
+            for (int x = 0; x < BOARD_SIZE; x++) {
+                board[y][x] = boardData[y * BOARD_SIZE + x];
             }
         }
+        boardDirty = true;
+    }
 
-        blackScore = whiteScore = 0;
-        for (const auto& row : board) {
-            for (char cell : row) {
-                if (cell == 'B') blackScore++;
-                else if (cell == 'W') whiteScore++;
-            }
+    // POSITION:<base64url> carries the same board as BOARD in the packed form of Compact.h
+    void updateBoardFromPacked(const std::string& text) {
+        std::string packed;
+        char cells[BOARD_SIZE * BOARD_SIZE];
+        bool whiteToMove;
+        if (!Compact::fromText(text, packed) || !Compact::unpackBoard(packed, cells, BOARD_SIZE, whiteToMove)) {
+            std::cout << "Received invalid packed board: " << text << std::endl;
+            return;
         }
+
+        std::string boardData(cells, BOARD_SIZE * BOARD_SIZE);
+        for (char& cell : boardData) {
+            cell = cell == 'b' ? 'B' : cell == 'w' ? 'W' : 's';
+        }
+        updateBoardFromServer(boardData);
     }
 
     void handleGameEnd(const std::string& message) {
@@ -524,6 +546,17 @@ private:
                 winner = "It's a tie!";
             }
 
+            // GAME_END:結果:黑子數:白子數, the final board may not be copied into the game logic yet
+            size_t pos2 = message.find(':', pos1 + 1);
+            if (pos2 != std::string::npos) {
+                try {
+                    blackScore = std::stoi(message.substr(pos1 + 1, pos2 - pos1 - 1));
+                    whiteScore = std::stoi(message.substr(pos2 + 1));
+                } catch (const std::exception&) {
+                    std::cout << "Unreadable final score: " << message << std::endl;
+                }
+            }
+
             createVictoryScreen(winner);
         }
 
@@ -551,8 +584,8 @@ private:
     void updateBoardPieces() {
         pieces.clear();
 
-        for (int y = 0; y < 8; y++) {
-            for (int x = 0; x < 8; x++) {
+        for (int y = 0; y < BOARD_SIZE; y++) {
+            for (int x = 0; x < BOARD_SIZE; x++) {
                 if (gameLogic.board[y][x] == 'a' && isMyTurn && connected && !gameOver) {
                     sf::CircleShape availableMove(cellSize / 2.0f - 20.0f);
                     availableMove.setFillColor(sf::Color(110, 140, 110, 150));
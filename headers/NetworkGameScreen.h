@@ -8,6 +8,7 @@
 
 #include "../headers/GameState.h"
 #include "../headers/Button.h"
+#include "../headers/FundamentalFunction.h"
 #include "../headers/Global.h"
 #include <SFML/Graphics.hpp>
 #include <SFML/Network.hpp>
@@ -21,7 +22,7 @@ class MainMenu;
 
 class NetworkGameScreen : public GameState {
 private:
-    static const int BOARD_SIZE = 8;
+    static const int BOARD_SIZE = BOARDLENGTH;
 
     // 网络相关
     sf::TcpSocket socket;
@@ -57,8 +58,8 @@ private:
 
     // 常量
     const float cellSize = 50.0f;
-    const float boardX = (WINDOW_WIDTH - 8 * cellSize) / 2.0f;
-    const float boardY = (WINDOW_HEIGHT - 8 * cellSize) / 2.0f + 20.0f;
+    const float boardX = (WINDOW_WIDTH - BOARD_SIZE * cellSize) / 2.0f;
+    const float boardY = (WINDOW_HEIGHT - BOARD_SIZE * cellSize) / 2.0f + 20.0f;
 
     int selectedX, selectedY;
 
@@ -116,8 +117,8 @@ public:
     void updateBoardPieces() {
         pieces.clear();
 
-        for (int y = 0; y < 8; y++) {
-            for (int x = 0; x < 8; x++) {
+        for (int y = 0; y < BOARD_SIZE; y++) {
+            for (int x = 0; x < BOARD_SIZE; x++) {
                 if (board[y][x] == 'B' || board[y][x] == 'W') {
                     sf::CircleShape piece(cellSize / 2.0f - 5.0f);
 
@@ -183,7 +184,7 @@ public:
         connectionText.setPosition({WINDOW_WIDTH - 200.0f, 100.0f});
 
         // 设置游戏板
-        boardBackground.setSize({cellSize * 8, cellSize * 8});
+        boardBackground.setSize({cellSize * BOARD_SIZE, cellSize * BOARD_SIZE});
         boardBackground.setPosition({boardX, boardY});
         boardBackground.setFillColor(sf::Color(30, 120, 30));
         boardBackground.setOutlineThickness(2.0f);
@@ -206,6 +207,8 @@ public:
 
     void updateBoardFromServer(const std::string &boardData);
 
+    void updateBoardFromPacked(const std::string &text);
+
     void handleGameEnd(const std::string &message);
 
     void handleInput(sf::Event event) override;
@@ -243,7 +246,7 @@ public:
         int boardCoordX = static_cast<int>((mousePos.x - boardX) / cellSize);
         int boardCoordY = static_cast<int>((mousePos.y - boardY) / cellSize);
 
-        if (boardCoordX >= 0 && boardCoordX < 8 && boardCoordY >= 0 && boardCoordY < 8) {
+        if (boardCoordX >= 0 && boardCoordX < BOARD_SIZE && boardCoordY >= 0 && boardCoordY < BOARD_SIZE) {
             selectedX = boardCoordX;
             selectedY = boardCoordY;
         } else {
@@ -258,16 +261,16 @@ public:
         window.draw(boardBackground);
 
         // 画网格线
-        for (int i = 0; i <= 8; i++) {
+        for (int i = 0; i <= BOARD_SIZE; i++) {
             sf::Vertex hLine[] = {
                 sf::Vertex{{boardX, boardY + i * cellSize}, sf::Color::Black},
-                sf::Vertex{{boardX + 8 * cellSize, boardY + i * cellSize}, sf::Color::Black}
+                sf::Vertex{{boardX + BOARD_SIZE * cellSize, boardY + i * cellSize}, sf::Color::Black}
             };
             window.draw(hLine, 2, sf::PrimitiveType::Lines);
 
             sf::Vertex vLine[] = {
                 sf::Vertex{{boardX + i * cellSize, boardY}, sf::Color::Black},
-                sf::Vertex{{boardX + i * cellSize, boardY + 8 * cellSize}, sf::Color::Black}
+                sf::Vertex{{boardX + i * cellSize, boardY + BOARD_SIZE * cellSize}, sf::Color::Black}
             };
             window.draw(vLine, 2, sf::PrimitiveType::Lines);
         }
@@ -0,0 +1,95 @@
+//
+// NeuralEvaluation.h - small quantized network with an incrementally updated first layer
+//
+
+#ifndef NEURALEVALUATION_H
+#define NEURALEVALUATION_H
+
+#include <cstdint>
+#include <string>
+
+#include "../headers/Bitboard.h"
+
+/**
+ * 128 inputs (own and opponent disc per square) -> 2 x 64 int16 accumulator
+ * -> 32 -> 32 -> 1, with int8 dense weights and activations clipped to [0, 127].
+ *
+ * Every side keeps its own accumulator: the sum of the input weights of its
+ * discs and the other side's discs. A move only touches the placed disc and
+ * the flipped discs, so search updates the accumulators instead of rebuilding them.
+ */
+class NeuralNetwork {
+public:
+    static constexpr int INPUTS = 128;
+    static constexpr int HIDDEN = 64;
+    static constexpr int LAYER1 = 32;
+    static constexpr int LAYER2 = 32;
+
+    static constexpr int ACTIVATION_MAX = 127;
+
+    // Dense layer sums are divided by 2^WEIGHT_SHIFT before clipping
+    static constexpr int WEIGHT_SHIFT = 6;
+
+    // Output sum per evaluation unit
+    static constexpr int OUTPUT_DIVISOR = 64;
+
+    // Evaluations stay below Search::FINAL_SCALE so they never look like finished games
+    static constexpr int MAX_EVAL = 999;
+
+    // Where the game looks for weights, relative to the executable's working directory
+    static constexpr const char *DEFAULT_PATH = "./weights/reversi.nnue";
+
+    struct alignas(32) Accumulator {
+        int16_t own[HIDDEN];    // seen by the side to move
+        int16_t other[HIDDEN];  // seen by the other side
+    };
+
+    NeuralNetwork() = default;
+
+    /**
+     * Read a weight file:
+     *   "RVNNUE01", uint32 version, uint32 HIDDEN, uint32 LAYER1, uint32 LAYER2, then little-endian
+     *   int16 input weights [INPUTS][HIDDEN], int16 input bias [HIDDEN],
+     *   int8 layer 1 weights [LAYER1][2 * HIDDEN], int32 layer 1 bias [LAYER1],
+     *   int8 layer 2 weights [LAYER2][LAYER1], int32 layer 2 bias [LAYER2],
+     *   int8 output weights [LAYER2], int32 output bias.
+     *
+     * @return false when the file is missing, truncated or has other layer sizes
+     */
+    bool load(const std::string &path);
+
+    bool isLoaded() const { return loaded; }
+
+    // Build both accumulators of `pos` from scratch
+    void refresh(const Position &pos, Accumulator &acc) const;
+
+    // Accumulators after the side to move plays `square` flipping `flips`
+    void update(const Accumulator &parent, Accumulator &child, int square, uint64_t flips) const;
+
+    // Accumulators after a pass
+    static void pass(const Accumulator &parent, Accumulator &child);
+
+    // Score for the side to move, in evaluation units
+    int evaluate(const Accumulator &acc) const;
+
+    int evaluate(const Position &pos) const;
+
+    /**
+     * Network loaded from DEFAULT_PATH on first use and shared by every search,
+     * or nullptr when no weight file is installed.
+     */
+    static const NeuralNetwork *shared();
+
+private:
+    alignas(32) int16_t inputWeights[INPUTS][HIDDEN]{};
+    alignas(32) int16_t inputBias[HIDDEN]{};
+    alignas(32) int8_t layer1Weights[LAYER1][2 * HIDDEN]{};
+    int32_t layer1Bias[LAYER1]{};
+    alignas(32) int8_t layer2Weights[LAYER2][LAYER1]{};
+    int32_t layer2Bias[LAYER2]{};
+    alignas(32) int8_t outputWeights[LAYER2]{};
+    int32_t outputBias = 0;
+    bool loaded = false;
+};
+
+#endif //NEURALEVALUATION_H
@@ -27,6 +27,7 @@ public:
      * @param player2Name Second player's name
      * @param isWhiteTurn Current player turn
      * @param vsComputer Whether playing against computer
+     * @param variations Move tree of the game, stored after the board as written
      * @return true if save successful, false otherwise
      */
     bool saveGame(const FundamentalFunction &gameLogic,
@@ -35,7 +36,8 @@ public:
                   bool isWhiteTurn,
                   bool vsComputer,
                   int player1Chance,
-                  int player2Chance);
+                  int player2Chance,
+                  const std::string &variations = "");
 
     /**
      * Load a saved game from file
@@ -46,6 +48,7 @@ public:
      * @param player2Name Output parameter for player 2's name
      * @param isWhiteTurn Output parameter for current turn
      * @param vsComputer Output parameter for computer opponent
+     * @param variations Output parameter for the move tree, left empty by saves without one
      * @return true if load successful, false otherwise
      */
     bool loadGame(const std::string &filename,
@@ -55,7 +58,8 @@ public:
                   bool &isWhiteTurn,
                   bool &vsComputer,
                   int &player1Chance,
-                  int &player2Chance
+                  int &player2Chance,
+                  std::string *variations = nullptr
                   );
 
     /**
@@ -0,0 +1,206 @@
+//
+// Search.h - alpha-beta search over bitboards of any board size with a transposition table
+//
+
+#ifndef SEARCH_H
+#define SEARCH_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "../headers/Arena.h"
+#include "../headers/Bitboard.h"
+#include "../headers/EndgameCache.h"
+#include "../headers/Evaluation.h"
+#include "../headers/GenericBoard.h"
+#include "../headers/NeuralEvaluation.h"
+#include "../headers/TimeManager.h"
+#include "../headers/TranspositionTable.h"
+
+// Score of one root move, seen from the side to move
+struct MoveScore {
+    int square;
+    int score;
+    bool exact;     // false: score is only an upper bound (move is outside the requested top K)
+};
+
+// Snapshot reported after every completed iteration
+struct AnalysisInfo {
+    int depth = 0;
+    std::vector<MoveScore> moves;   // best first
+    uint64_t nodes = 0;
+    double seconds = 0.0;
+};
+
+/**
+ * Search of an N x N board over GenericBoard<N>. Every size gets the same
+ * iterative deepening, multi-PV root analysis and limits; the endgame cache
+ * and the neural network only exist for 8x8, which the rest of the engine
+ * knows as Search.
+ */
+template<int N>
+class GenericSearch {
+public:
+    using Board = GenericBoard<N>;
+    using Geometry = BoardGeometry<N>;
+    using Mask = typename Geometry::Mask;
+    using Pos = typename Board::Pos;
+
+    static constexpr int INF = 1000000;
+
+    // Finished games score disc difference * FINAL_SCALE, above any evaluation
+    static constexpr int FINAL_SCALE = 1000;
+
+    explicit GenericSearch(size_t ttMegabytes = 16);
+
+    /**
+     * Score the root moves with iterative deepening up to `maxDepth` plies,
+     * sharing one transposition table across all root moves and iterations.
+     *
+     * @param multiPV number of best moves to score exactly, 0 for every legal move
+     * @param onDepth called after each completed iteration
+     * @return the last completed iteration, best first (empty when the side to move must pass)
+     */
+    std::vector<MoveScore> analyze(const Pos &pos, int maxDepth, int multiPV = 0,
+                                   const std::function<void(const AnalysisInfo &)> &onDepth = nullptr);
+
+    // Best move square, or Geometry::PASS when there is no legal move
+    int bestMove(const Pos &pos, int depth);
+
+    // Exact score of playing the legal move `square`, searched `depth` plies deep including that move
+    int scoreMove(const Pos &pos, int square, int depth);
+
+    /**
+     * Solve `pos` to the end of the game with perfect play on both sides.
+     * @return best move (Geometry::PASS when the side to move must pass) and the
+     *         final disc difference; when stopped before the end `exact` is false
+     *         and the score is the estimate of the last completed depth
+     */
+    MoveScore solve(const Pos &pos);
+
+    /**
+     * Abort a running analyze() from another thread; the last completed
+     * iteration is returned. The flag stays set until clearStop().
+     */
+    void requestStop() { stopRequested.store(true, std::memory_order_relaxed); }
+
+    void clearStop() { stopRequested.store(false, std::memory_order_relaxed); }
+
+    // Forget all stored positions
+    void clear();
+
+    /**
+     * Evaluate leaves with `network` instead of the handcrafted evaluation,
+     * nullptr to switch back. The network must outlive the search.
+     */
+    template<int M = N>
+    void setNetwork(const NeuralNetwork *network) {
+        static_assert(M == 8, "the network is trained on the 8x8 board");
+        if (network == this->network) {
+            return;
+        }
+
+        // Stored scores came from the other evaluation
+        this->network = network;
+        clear();
+        if (network && accumulators.empty()) {
+            accumulators.resize(MAX_PLY + 1);
+        }
+    }
+
+    /**
+     * Evaluate leaves without a network using `weights`, by default the shared
+     * weights file. The weights must outlive the search.
+     */
+    void setEvaluationWeights(const Evaluation::Weights &weights) { evaluationWeights = &weights; }
+
+    /**
+     * Look up and record exactly solved endgames in `cache`, nullptr for none.
+     * The cache may be shared by several searches and must outlive them.
+     */
+    template<int M = N>
+    void setEndgameCache(EndgameCache *cache) {
+        static_assert(M == 8, "the endgame cache stores 8x8 positions");
+        endgameCache = cache;
+    }
+
+    /**
+     * Limit the thinking time of every following analyze(): no iteration starts
+     * after half of `budget.target` and the search is abandoned at
+     * `budget.maximum`. The first iteration always completes. A default
+     * budget removes the limits.
+     */
+    void setTimeBudget(const TimeBudget &budget) { timeBudget = budget; }
+
+    /**
+     * Limit every following analyze() to about `maxNodes` nodes, 0 for no
+     * limit. As with the time budget no iteration starts after half of it
+     * and the first iteration always completes.
+     */
+    void setNodeLimit(const uint64_t maxNodes) { nodeLimit = maxNodes; }
+
+    // Nodes searched by the last analyze, bestMove or scoreMove call
+    uint64_t getNodes() const { return nodes; }
+
+    // Most bytes of root move lists held at once, over all analyze() calls
+    size_t getArenaPeak() const { return arena.getPeak(); }
+
+    static bool isFinalScore(int score) { return score >= FINAL_SCALE || score <= -FINAL_SCALE; }
+
+    static int discDifference(int score) { return score / FINAL_SCALE; }
+
+    // Exact result of a finished game, empties go to the winner
+    static int finalScore(const Pos &pos);
+
+private:
+    // Deepest ply: every move or pass of a whole game plus the root
+    static constexpr int MAX_PLY = 2 * Geometry::CELLS + 2;
+
+    // Root move lists of one analyze(), reused from call to call
+    static constexpr size_t ROOT_ARENA_BYTES = 4096;
+
+    int negamax(const Pos &pos, int depth, int alpha, int beta);
+
+    // Negated score of the child after playing `square`, keeping the network accumulators in step
+    int searchChild(const Pos &pos, int square, Mask flips, int depth, int alpha, int beta);
+
+    // Leaf score from the network or the handcrafted evaluation
+    int evaluate(const Pos &pos) const;
+
+    // Reset the per-search state for a new root
+    void prepareRoot(const Pos &pos);
+
+    // Fill `order` with the squares of `moves`, most promising first; returns the count
+    static int orderMoves(const Pos &pos, Mask moves, int ttMove, int depth, int order[]);
+
+    TranspositionTable tt;
+    size_t ttMegabytes;
+    uint64_t nodes = 0;
+    bool aborted = false;
+    bool canAbort = false;
+    std::atomic<bool> stopRequested{false};
+    TimeBudget timeBudget;
+    uint64_t nodeLimit = 0;
+    std::chrono::steady_clock::time_point deadline;
+    Arena arena{ROOT_ARENA_BYTES};
+
+    EndgameCache *endgameCache = nullptr;
+
+    const Evaluation::Weights *evaluationWeights = &Evaluation::shared();
+    const NeuralNetwork *network = nullptr;
+    std::vector<NeuralNetwork::Accumulator> accumulators;
+    int ply = 0;
+};
+
+// The 8x8 engine, with the endgame cache and the network
+using Search = GenericSearch<8>;
+
+// Instantiated once in Search.cpp for every supported size
+extern template class GenericSearch<6>;
+extern template class GenericSearch<8>;
+extern template class GenericSearch<10>;
+
+#endif //SEARCH_H
@@ -0,0 +1,67 @@
+//
+// SearchTrace.h - compile-time optional binary recorder for search events
+//
+
+#ifndef SEARCHTRACE_H
+#define SEARCHTRACE_H
+
+#include <cstdint>
+#include <string>
+
+// Kinds of events written by the search
+enum class TraceEventType : uint8_t {
+    NODE_ENTER = 0,
+    NODE_EXIT = 1,
+    CUTOFF = 2,     // beta cutoff, moveIndex is the position in the move order
+    TT_PROBE = 3,   // transposition table lookup that missed
+    TT_HIT = 4      // transposition table lookup that found an entry
+};
+
+// One 8-byte record as stored in the trace file
+struct TraceEvent {
+    uint8_t type;       // TraceEventType
+    uint8_t depth;      // remaining search depth
+    uint8_t moveIndex;  // index in move order, 0xFF when not applicable
+    uint8_t square;     // y * 8 + x, 0xFF when not applicable
+    uint16_t thread;    // recording thread id
+    int16_t score;      // node score (exit events only)
+};
+
+static_assert(sizeof(TraceEvent) == 8, "TraceEvent must stay 8 bytes");
+
+// File layout: 8-byte magic, uint32 version, uint32 event size, then raw events
+constexpr char TRACE_MAGIC[8] = {'R', 'V', 'T', 'R', 'A', 'C', 'E', '1'};
+constexpr uint32_t TRACE_VERSION = 1;
+
+class SearchTrace {
+public:
+    // Size of each thread's ring; recording only waits when the writer falls this far behind
+    static constexpr int BUFFER_EVENTS = 1 << 18;
+
+    /**
+     * Select the trace file. Defaults to $REVERSI_TRACE_FILE or "search_trace.bin".
+     * Must be called before the first event is written out to take effect.
+     */
+    static void setOutputFile(const std::string &path);
+
+    /**
+     * Append one event to the calling thread's ring. Never takes a lock and
+     * never touches the file; a background thread writes the rings out.
+     */
+    static void record(TraceEventType type, int depth, int moveIndex, int square, int score);
+
+    // Wait until the calling thread's events are written and flushed to the trace file
+    static void flush();
+};
+
+// Search code uses these so a normal build carries no tracing cost at all
+#ifdef REVERSI_SEARCH_TRACE
+#define SEARCH_TRACE(type, depth, moveIndex, square, score) \
+    SearchTrace::record(TraceEventType::type, depth, moveIndex, square, score)
+#define SEARCH_TRACE_FLUSH() SearchTrace::flush()
+#else
+#define SEARCH_TRACE(type, depth, moveIndex, square, score) ((void) 0)
+#define SEARCH_TRACE_FLUSH() ((void) 0)
+#endif
+
+#endif //SEARCHTRACE_H
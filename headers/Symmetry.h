@@ -0,0 +1,137 @@
+//
+// Symmetry.h - the eight board symmetries and canonical positions
+//
+// A transform is a 3-bit number applied in this order: bit 0 transposes
+// along the a1-h8 diagonal, bit 1 mirrors left-right, bit 2 flips top-bottom.
+// Transform 0 is the identity.
+//
+
+#ifndef SYMMETRY_H
+#define SYMMETRY_H
+
+#include <cstdint>
+
+#ifdef _MSC_VER
+#include <stdlib.h>
+#endif
+
+#include "../headers/Bitboard.h"
+
+namespace Symmetry {
+    constexpr int COUNT = 8;
+
+    constexpr int TRANSPOSE = 1;
+    constexpr int MIRROR = 2;
+    constexpr int FLIP = 4;
+
+    // Swap the bits selected by `mask` with the bits `delta` places above them
+    inline uint64_t deltaSwap(const uint64_t bits, const uint64_t mask, const int delta) {
+        const uint64_t t = (bits ^ (bits >> delta)) & mask;
+        return bits ^ t ^ (t << delta);
+    }
+
+    // Row y goes to row 7 - y
+    inline uint64_t flipVertical(const uint64_t bits) {
+#ifdef _MSC_VER
+        return _byteswap_uint64(bits);
+#else
+        return __builtin_bswap64(bits);
+#endif
+    }
+
+    // Column x goes to column 7 - x
+    inline uint64_t mirrorHorizontal(uint64_t bits) {
+        bits = deltaSwap(bits, 0x5555555555555555ULL, 1);
+        bits = deltaSwap(bits, 0x3333333333333333ULL, 2);
+        return deltaSwap(bits, 0x0F0F0F0F0F0F0F0FULL, 4);
+    }
+
+    // (x, y) goes to (y, x)
+    inline uint64_t transpose(uint64_t bits) {
+        bits = deltaSwap(bits, 0x00AA00AA00AA00AAULL, 7);
+        bits = deltaSwap(bits, 0x0000CCCC0000CCCCULL, 14);
+        return deltaSwap(bits, 0x00000000F0F0F0F0ULL, 28);
+    }
+
+    inline uint64_t transform(uint64_t bits, const int t) {
+        if (t & TRANSPOSE) {
+            bits = transpose(bits);
+        }
+        if (t & MIRROR) {
+            bits = mirrorHorizontal(bits);
+        }
+        if (t & FLIP) {
+            bits = flipVertical(bits);
+        }
+        return bits;
+    }
+
+    inline Position transform(const Position &pos, const int t) {
+        return {transform(pos.player, t), transform(pos.opponent, t)};
+    }
+
+    // Transform undoing `t`: after a transpose, mirroring and flipping trade places
+    inline int inverse(const int t) {
+        return (t & TRANSPOSE) ? (t & TRANSPOSE) | ((t & MIRROR) << 1) | ((t & FLIP) >> 1) : t;
+    }
+
+    // Square that `square` moves to under `t`; PASS stays PASS
+    inline int transformSquare(const int square, const int t) {
+        if (square < 0 || square >= 64) {
+            return square;
+        }
+
+        int x = square % 8;
+        int y = square / 8;
+        if (t & TRANSPOSE) {
+            const int swap = x;
+            x = y;
+            y = swap;
+        }
+        if (t & MIRROR) {
+            x = 7 - x;
+        }
+        if (t & FLIP) {
+            y = 7 - y;
+        }
+        return y * 8 + x;
+    }
+
+    // Order used to pick the canonical variant: player mask first, then opponent mask
+    inline bool less(const Position &a, const Position &b) {
+        return a.player != b.player ? a.player < b.player : a.opponent < b.opponent;
+    }
+
+    /**
+     * Smallest of the eight variants of `pos`, the same for every position in
+     * its symmetry class. `usedTransform` receives the transform that maps
+     * `pos` onto it; inverse() maps canonical moves back to `pos`.
+     */
+    inline Position canonical(const Position &pos, int &usedTransform) {
+        // Build the variants in transform order so each costs a single operation
+        Position variants[COUNT];
+        variants[0] = pos;
+        variants[TRANSPOSE] = {transpose(pos.player), transpose(pos.opponent)};
+        for (int t = 0; t < MIRROR; t++) {
+            variants[t | MIRROR] = {mirrorHorizontal(variants[t].player), mirrorHorizontal(variants[t].opponent)};
+        }
+        for (int t = 0; t < FLIP; t++) {
+            variants[t | FLIP] = {flipVertical(variants[t].player), flipVertical(variants[t].opponent)};
+        }
+
+        usedTransform = 0;
+        for (int t = 1; t < COUNT; t++) {
+            if (less(variants[t], variants[usedTransform])) {
+                usedTransform = t;
+            }
+        }
+        return variants[usedTransform];
+    }
+
+    inline Position canonical(const Position &pos) {
+        int usedTransform;
+        return canonical(pos, usedTransform);
+    }
+}
+
+#endif //SYMMETRY_H
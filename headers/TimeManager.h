@@ -0,0 +1,81 @@
+//
+// TimeManager.h - per-move thinking time from the game clock
+//
+
+#ifndef TIMEMANAGER_H
+#define TIMEMANAGER_H
+
+#include <algorithm>
+
+// Thinking time for one move
+struct TimeBudget {
+    double target = 0.0;    // seconds after which no new iteration starts, 0 for no limit
+    double maximum = 0.0;   // seconds after which the search is abandoned, 0 for no limit
+    bool instant = false;   // only one legal move: play it without searching
+};
+
+/**
+ * The game Timer gives each move its own clock and takes a chance away when
+ * it runs out. The budget aims at a share of what is left on that clock,
+ * weighted by game phase and by the number of moves to choose from, and the
+ * hard limit always leaves a margin so the AI never loses a chance.
+ */
+namespace TimeManager {
+    // Kept back from every clock for the frame loop and for unwinding the search
+    constexpr double SAFETY_SECONDS = 1.5;
+
+    // Share of the remaining time aimed at by an ordinary midgame move
+    constexpr double TARGET_SHARE = 0.2;
+
+    // Share of the usable time the search may run to, lower when one more timeout loses the game
+    constexpr double MAXIMUM_SHARE = 0.8;
+    constexpr double LAST_CHANCE_MAXIMUM_SHARE = 0.5;
+
+    /**
+     * Weight of the game phase. Opening positions are alike and forgiving,
+     * the late midgame decides most games, and endgames are searched to the
+     * end quickly.
+     */
+    inline double phaseWeight(const int empties) {
+        if (empties > 44) {
+            return 0.4;
+        }
+        if (empties > 30) {
+            return 1.0;
+        }
+        if (empties > 20) {
+            return 1.3;
+        }
+        return 0.7;
+    }
+
+    /**
+     * Budget for the side to move.
+     * @param remainingSeconds time left on its clock for this move
+     * @param remainingChances timeouts it can still afford, the game is lost at 0
+     * @param empties empty squares on the board
+     * @param legalMoves legal moves of the side to move
+     */
+    inline TimeBudget allocate(const double remainingSeconds, const int remainingChances, const int empties,
+                               const int legalMoves) {
+        TimeBudget budget;
+        if (legalMoves <= 1) {
+            budget.instant = true;
+            return budget;
+        }
+
+        const double usable = std::max(0.0, remainingSeconds - SAFETY_SECONDS);
+        const double share = remainingChances <= 1 ? LAST_CHANCE_MAXIMUM_SHARE : MAXIMUM_SHARE;
+
+        // A small positive limit still lets the first iteration finish
+        budget.maximum = std::max(0.01, usable * share);
+
+        // More choices take longer to tell apart
+        const double complexity = std::clamp(legalMoves / 10.0, 0.6, 1.4);
+        budget.target = std::min(budget.maximum,
+                                 remainingSeconds * TARGET_SHARE * phaseWeight(empties) * complexity);
+        return budget;
+    }
+}
+
+#endif //TIMEMANAGER_H
@@ -0,0 +1,78 @@
+//
+// TrainingData.h - fixed-size binary records of scored positions for evaluation training
+//
+
+#ifndef TRAININGDATA_H
+#define TRAININGDATA_H
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Flags of a TrainingRecord
+constexpr uint8_t RECORD_WHITE_TO_MOVE = 1;     // the side to move is white
+constexpr uint8_t RECORD_EXACT_SEARCH = 2;      // searchScore is an exact final disc difference
+
+/**
+ * One 24-byte little-endian record, every score from the side to move:
+ *   player, opponent   bitboards of the side to move and the other side
+ *   searchScore        shallow search result (evaluation units, or discs with RECORD_EXACT_SEARCH)
+ *   finalScore         disc difference at the end of the game
+ *   flags              RECORD_* bits
+ *   empties            empty squares
+ */
+struct TrainingRecord {
+    uint64_t player;
+    uint64_t opponent;
+    int16_t searchScore;
+    int8_t finalScore;
+    uint8_t flags;
+    uint8_t empties;
+    uint8_t reserved[3];
+};
+
+static_assert(sizeof(TrainingRecord) == 24, "TrainingRecord must stay 24 bytes");
+
+// File layout: 8-byte magic, uint32 version, uint32 record size, then raw records
+constexpr char TRAINING_MAGIC[8] = {'R', 'V', 'D', 'A', 'T', 'A', '0', '1'};
+constexpr uint32_t TRAINING_VERSION = 1;
+
+// Shared output file; producers buffer records themselves and hand them over in batches
+class TrainingDataWriter {
+public:
+    TrainingDataWriter() = default;
+
+    ~TrainingDataWriter();
+
+    TrainingDataWriter(const TrainingDataWriter &) = delete;
+
+    TrainingDataWriter &operator=(const TrainingDataWriter &) = delete;
+
+    // Create `path` and write the header; false when it can't be opened
+    bool open(const std::string &path);
+
+    // Append a batch of records, safe to call from several threads
+    void write(const std::vector<TrainingRecord> &records);
+
+    void close();
+
+    uint64_t getRecordsWritten() const { return recordsWritten.load(); }
+
+private:
+    std::mutex mutex;
+    FILE *file = nullptr;
+    std::atomic<uint64_t> recordsWritten{0};
+};
+
+namespace TrainingData {
+    /**
+     * Load every record of a training file.
+     * @return false when the file is missing or has a different magic, version or record size
+     */
+    bool read(const std::string &path, std::vector<TrainingRecord> &records);
+}
+
+#endif //TRAININGDATA_H
@@ -0,0 +1,43 @@
+//
+// Transcript.h - game transcripts written as square names ("f5d6c3d3...")
+//
+
+#ifndef TRANSCRIPT_H
+#define TRANSCRIPT_H
+
+#include <string>
+#include <vector>
+
+#include "../headers/Bitboard.h"
+
+// One replayed game: every position before each move, black starts
+struct GameLine {
+    std::vector<int> moves;             // squares played, forced passes not included
+    std::vector<Position> positions;    // position before moves[i], from the mover's view
+    std::vector<bool> whiteToMove;      // colour of the player making moves[i]
+    Position finalPosition{};
+    bool finalWhiteToMove = false;
+};
+
+namespace Transcript {
+    /**
+     * Replay a transcript from the starting position.
+     * Moves may be separated by spaces; passes are inserted automatically
+     * and may also be written as "pa" or "--".
+     *
+     * @param error set to a message when a move is illegal or unreadable
+     * @return false when the transcript is invalid
+     */
+    bool parse(const std::string &text, GameLine &game, std::string &error);
+
+    /**
+     * Replay squares from the starting position, as parse() does for text.
+     * Passes are inserted automatically and may also be given as Bitboard::PASS.
+     */
+    bool replay(const std::vector<int> &moves, GameLine &game, std::string &error);
+
+    // Concatenated square names of `moves`
+    std::string format(const std::vector<int> &moves);
+}
+
+#endif //TRANSCRIPT_H
@@ -0,0 +1,64 @@
+//
+// TranspositionTable.h - fixed-size hash table of searched positions
+//
+
+#ifndef TRANSPOSITIONTABLE_H
+#define TRANSPOSITIONTABLE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// How the stored score relates to the true value
+enum class Bound : uint8_t {
+    NONE = 0,
+    EXACT = 1,
+    LOWER = 2,  // score >= stored (fail high)
+    UPPER = 3   // score <= stored (fail low)
+};
+
+struct TTEntry {
+    uint64_t key = 0;
+    int32_t score = 0;
+    int8_t depth = -1;
+    Bound bound = Bound::NONE;
+    uint8_t bestMove = 0xFF;
+};
+
+class TranspositionTable {
+public:
+    // Memory is only allocated by the first resize(), so idle owners cost nothing
+    TranspositionTable() = default;
+
+    // Allocate roughly `megabytes` of entries (rounded down to a power of two)
+    void resize(size_t megabytes);
+
+    void clear();
+
+    bool empty() const { return entries.empty(); }
+
+    // Entry for `key`, or nullptr when the slot holds another position
+    const TTEntry *probe(uint64_t key) const {
+        const TTEntry &entry = entries[key & mask];
+        return entry.key == key && entry.bound != Bound::NONE ? &entry : nullptr;
+    }
+
+    // Always replaces, except that a shallower bound never overwrites a deeper entry of the same position
+    void store(uint64_t key, int score, int depth, Bound bound, int bestMove) {
+        TTEntry &entry = entries[key & mask];
+        if (entry.key == key && entry.depth > depth && bound != Bound::EXACT) {
+            return;
+        }
+        entry.key = key;
+        entry.score = score;
+        entry.depth = static_cast<int8_t>(depth);
+        entry.bound = bound;
+        entry.bestMove = static_cast<uint8_t>(bestMove);
+    }
+
+private:
+    std::vector<TTEntry> entries;
+    uint64_t mask = 0;
+};
+
+#endif //TRANSPOSITIONTABLE_H
@@ -0,0 +1,25 @@
+//
+// Arena.cpp - bump arena allocation
+//
+
+#include "../headers/Arena.h"
+
+Arena::Arena(const size_t bytes) : block(std::make_unique<unsigned char[]>(bytes)), capacity(bytes) {
+}
+
+void *Arena::allocate(const size_t bytes, const size_t alignment) {
+    const uintptr_t base = reinterpret_cast<uintptr_t>(block.get());
+    const uintptr_t start = (base + used + alignment - 1) & ~static_cast<uintptr_t>(alignment - 1);
+    const size_t end = start - base + bytes;
+    if (end > capacity) {
+        return nullptr;
+    }
+
+    used = end;
+    return reinterpret_cast<void *>(start);
+}
+
+void Arena::reset() {
+    peak = getPeak();
+    used = 0;
+}
@@ -0,0 +1,226 @@
+//
+// BatchPlayout.cpp - scalar and AVX2 playout kernels
+//
+
+#include "../headers/BatchPlayout.h"
+#include "../headers/CpuFeatures.h"
+
+#if defined(REVERSI_AVX2)
+#include <immintrin.h>
+#endif
+
+namespace {
+    // Index of the random move among `moves`, corners first; narrows `moves` to the candidates
+    inline unsigned pickIndex(uint64_t &moves, uint64_t &rng) {
+        if (moves & Bitboard::CORNERS) {
+            moves &= Bitboard::CORNERS;
+        }
+
+        // Multiply-shift maps 32 random bits onto [0, count) without a division
+        const uint64_t count = Bitboard::popcount(moves);
+        return static_cast<unsigned>(((BatchPlayout::nextRandom(rng) >> 32) * count) >> 32);
+    }
+
+    // Random legal move as a single bit, corners first
+    inline uint64_t pickMove(uint64_t moves, uint64_t &rng) {
+        const unsigned index = pickIndex(moves, rng);
+        for (unsigned i = 0; i < index; i++) {
+            moves &= moves - 1;
+        }
+        return moves & (0 - moves);
+    }
+
+#if defined(REVERSI_AVX2)
+    // pickMove with the index-th move deposited by pdep
+    REVERSI_TARGET_AVX2 inline uint64_t pickMoveBmi2(uint64_t moves, uint64_t &rng) {
+        const unsigned index = pickIndex(moves, rng);
+        return _pdep_u64(1ULL << index, moves);
+    }
+
+    // Same flood fill as Bitboard::getMoves, on four boards at once
+    REVERSI_TARGET_AVX2 inline __m256i getMoves4(const __m256i player, const __m256i opponent) {
+        const __m256i inner = _mm256_and_si256(opponent, _mm256_set1_epi64x(0x7E7E7E7E7E7E7E7ELL));
+        __m256i moves = _mm256_setzero_si256();
+
+#define REVERSI_FLOOD(shift, mask)                                                   \
+        {                                                                            \
+            __m256i left = _mm256_and_si256(mask, _mm256_slli_epi64(player, shift));  \
+            __m256i right = _mm256_and_si256(mask, _mm256_srli_epi64(player, shift)); \
+            for (int i = 0; i < 5; i++) {                                             \
+                left = _mm256_or_si256(left, _mm256_and_si256(mask, _mm256_slli_epi64(left, shift)));   \
+                right = _mm256_or_si256(right, _mm256_and_si256(mask, _mm256_srli_epi64(right, shift))); \
+            }                                                                        \
+            moves = _mm256_or_si256(moves, _mm256_slli_epi64(left, shift));           \
+            moves = _mm256_or_si256(moves, _mm256_srli_epi64(right, shift));          \
+        }
+
+        REVERSI_FLOOD(1, inner)
+        REVERSI_FLOOD(8, opponent)
+        REVERSI_FLOOD(7, inner)
+        REVERSI_FLOOD(9, inner)
+#undef REVERSI_FLOOD
+
+        return _mm256_andnot_si256(_mm256_or_si256(player, opponent), moves);
+    }
+
+    // Discs flipped by the single-bit moves in each lane (a zero move flips nothing)
+    REVERSI_TARGET_AVX2 inline __m256i getFlips4(const __m256i player, const __m256i opponent, const __m256i move) {
+        const __m256i inner = _mm256_and_si256(opponent, _mm256_set1_epi64x(0x7E7E7E7E7E7E7E7ELL));
+        const __m256i zero = _mm256_setzero_si256();
+        __m256i flips = zero;
+
+        // A run of opponent discs counts only when the next cell holds a player disc
+#define REVERSI_RAY(SHIFT, shift, mask)                                                    \
+        {                                                                                  \
+            __m256i line = _mm256_and_si256(mask, SHIFT(move, shift));                     \
+            for (int i = 0; i < 5; i++) {                                                  \
+                line = _mm256_or_si256(line, _mm256_and_si256(mask, SHIFT(line, shift)));  \
+            }                                                                              \
+            const __m256i closed = _mm256_cmpeq_epi64(_mm256_and_si256(SHIFT(line, shift), player), zero); \
+            flips = _mm256_or_si256(flips, _mm256_andnot_si256(closed, line));             \
+        }
+
+        REVERSI_RAY(_mm256_slli_epi64, 1, inner)
+        REVERSI_RAY(_mm256_srli_epi64, 1, inner)
+        REVERSI_RAY(_mm256_slli_epi64, 8, opponent)
+        REVERSI_RAY(_mm256_srli_epi64, 8, opponent)
+        REVERSI_RAY(_mm256_slli_epi64, 7, inner)
+        REVERSI_RAY(_mm256_srli_epi64, 7, inner)
+        REVERSI_RAY(_mm256_slli_epi64, 9, inner)
+        REVERSI_RAY(_mm256_srli_epi64, 9, inner)
+#undef REVERSI_RAY
+
+        return flips;
+    }
+#endif
+}
+
+int BatchPlayout::single(Position pos, uint64_t &rng) {
+    int sign = 1;
+    for (;;) {
+        const uint64_t moves = Bitboard::getMoves(pos.player, pos.opponent);
+        if (!moves) {
+            if (!Bitboard::getMoves(pos.opponent, pos.player)) {
+                break;
+            }
+            pos = Bitboard::pass(pos);
+            sign = -sign;
+            continue;
+        }
+
+        const int square = Bitboard::lowestSquare(pickMove(moves, rng));
+        pos = Bitboard::play(pos, square, Bitboard::getFlips(pos.player, pos.opponent, square));
+        sign = -sign;
+    }
+
+    return sign * (Bitboard::popcount(pos.player) - Bitboard::popcount(pos.opponent));
+}
+
+#if defined(REVERSI_AVX2)
+namespace {
+    REVERSI_TARGET_AVX2 void runAvx2(const Position *starts, const int count, int *results, uint64_t &rng) {
+        using BatchPlayout::LANES;
+
+        alignas(32) uint64_t player[LANES];
+        alignas(32) uint64_t opponent[LANES];
+        alignas(32) uint64_t moves[LANES];
+        alignas(32) uint64_t chosen[LANES];
+
+        int game[LANES];        // index into starts, -1 for an idle lane
+        int sign[LANES];        // +1 while the lane's side to move is the starting side
+        bool passed[LANES];     // the previous step of the lane was a pass
+        int next = 0;
+
+        // A new game enters with its colours swapped and a zero move, so the
+        // swap done by the next step puts it the right way round
+        auto refill = [&](const int lane) {
+            if (next < count) {
+                player[lane] = starts[next].opponent;
+                opponent[lane] = starts[next].player;
+                game[lane] = next++;
+                sign[lane] = -1;
+            } else {
+                player[lane] = opponent[lane] = 0;
+                game[lane] = -1;
+            }
+            passed[lane] = false;
+            chosen[lane] = 0;
+        };
+
+        for (int lane = 0; lane < LANES; lane++) {
+            refill(lane);
+        }
+
+        __m256i p = _mm256_load_si256(reinterpret_cast<const __m256i *>(player));
+        __m256i o = _mm256_load_si256(reinterpret_cast<const __m256i *>(opponent));
+
+        int active = count < LANES ? count : LANES;
+        bool first = true;
+
+        while (active > 0) {
+            if (!first) {
+                _mm256_store_si256(reinterpret_cast<__m256i *>(moves), getMoves4(p, o));
+
+                bool refilled = false;
+                for (int lane = 0; lane < LANES; lane++) {
+                    chosen[lane] = 0;
+                    if (game[lane] < 0) {
+                        continue;
+                    }
+
+                    if (moves[lane]) {
+                        chosen[lane] = pickMoveBmi2(moves[lane], rng);
+                        passed[lane] = false;
+                    } else if (!passed[lane]) {
+                        // Pass: the zero move swaps the sides
+                        passed[lane] = true;
+                    } else {
+                        // Neither side can move: the game is over
+                        if (!refilled) {
+                            _mm256_store_si256(reinterpret_cast<__m256i *>(player), p);
+                            _mm256_store_si256(reinterpret_cast<__m256i *>(opponent), o);
+                            refilled = true;
+                        }
+                        const int discs = Bitboard::popcount(player[lane]) - Bitboard::popcount(opponent[lane]);
+                        results[game[lane]] = sign[lane] * discs;
+                        refill(lane);
+                        if (game[lane] < 0) {
+                            active--;
+                        }
+                    }
+                    sign[lane] = -sign[lane];
+                }
+
+                if (refilled) {
+                    p = _mm256_load_si256(reinterpret_cast<const __m256i *>(player));
+                    o = _mm256_load_si256(reinterpret_cast<const __m256i *>(opponent));
+                }
+            } else {
+                // Entering games only need their swap
+                for (int lane = 0; lane < LANES; lane++) {
+                    sign[lane] = -sign[lane];
+                }
+                first = false;
+            }
+
+            const __m256i move = _mm256_load_si256(reinterpret_cast<const __m256i *>(chosen));
+            const __m256i flips = getFlips4(p, o, move);
+            const __m256i newPlayer = _mm256_xor_si256(o, flips);
+            o = _mm256_xor_si256(_mm256_xor_si256(p, flips), move);
+            p = newPlayer;
+        }
+    }
+}
+#endif
+
+void BatchPlayout::run(const Position *starts, const int count, int *results, uint64_t &rng) {
+#if defined(REVERSI_AVX2)
+    if (CpuFeatures::avx2()) {
+        runAvx2(starts, count, results, rng);
+        return;
+    }
+#endif
+    for (int i = 0; i < count; i++) {
+        results[i] = single(starts[i], rng);
+    }
+}
@@ -0,0 +1,60 @@
+//
+// Bitboard.cpp - conversions between the char board and bitboards
+//
+
+#include "../headers/Bitboard.h"
+
+#include <cctype>
+
+Position Bitboard::initial() {
+    // d5/e4 black, d4/e5 white
+    return {squareBit(3 * 8 + 4) | squareBit(4 * 8 + 3), squareBit(3 * 8 + 3) | squareBit(4 * 8 + 4)};
+}
+
+Position Bitboard::fromBoard(const char board[SIZE][SIZE], const bool isWhiteTurn) {
+    uint64_t black = 0;
+    uint64_t white = 0;
+
+    for (int y = 0; y < SIZE; y++) {
+        for (int x = 0; x < SIZE; x++) {
+            if (board[y][x] == 'b') {
+                black |= squareBit(y * 8 + x);
+            } else if (board[y][x] == 'w') {
+                white |= squareBit(y * 8 + x);
+            }
+        }
+    }
+
+    return isWhiteTurn ? Position{white, black} : Position{black, white};
+}
+
+void Bitboard::toBoard(const Position &pos, const bool isWhiteTurn, char board[SIZE][SIZE]) {
+    const uint64_t white = isWhiteTurn ? pos.player : pos.opponent;
+    const uint64_t black = isWhiteTurn ? pos.opponent : pos.player;
+
+    for (int y = 0; y < SIZE; y++) {
+        for (int x = 0; x < SIZE; x++) {
+            const uint64_t bit = squareBit(y * 8 + x);
+            board[y][x] = (black & bit) ? 'b' : (white & bit) ? 'w' : 's';
+        }
+    }
+}
+
+std::string Bitboard::squareName(const int square) {
+    if (square < 0 || square >= 64) {
+        return "pass";
+    }
+    return {static_cast<char>('a' + square % 8), static_cast<char>('1' + square / 8)};
+}
+
+int Bitboard::parseSquare(const std::string &name) {
+    if (name.size() != 2) {
+        return -1;
+    }
+    const int x = std::tolower(static_cast<unsigned char>(name[0])) - 'a';
+    const int y = name[1] - '1';
+    if (x < 0 || x >= 8 || y < 0 || y >= 8) {
+        return -1;
+    }
+    return y * 8 + x;
+}
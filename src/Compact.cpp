@@ -0,0 +1,220 @@
+//
+// Compact.cpp - packing and unpacking of positions, move lists and game files
+//
+
+#include "../headers/Compact.h"
+
+#include <cstring>
+
+namespace {
+    constexpr char BASE64[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+
+    int base64Value(const char c) {
+        const char *found = std::strchr(BASE64, c);
+        return c && found ? static_cast<int>(found - BASE64) : -1;
+    }
+
+    void writeWord(uint8_t *out, const uint64_t word) {
+        for (int i = 0; i < 8; i++) {
+            out[i] = static_cast<uint8_t>(word >> (8 * i));
+        }
+    }
+
+    uint64_t readWord(const uint8_t *in) {
+        uint64_t word = 0;
+        for (int i = 0; i < 8; i++) {
+            word |= static_cast<uint64_t>(in[i]) << (8 * i);
+        }
+        return word;
+    }
+
+    bool getBit(const std::string &bytes, const size_t offset, const int bit) {
+        return (static_cast<uint8_t>(bytes[offset + bit / 8]) >> (bit % 8)) & 1;
+    }
+
+    void setBit(std::string &bytes, const size_t offset, const int bit) {
+        bytes[offset + bit / 8] = static_cast<char>(static_cast<uint8_t>(bytes[offset + bit / 8]) | 1 << (bit % 8));
+    }
+}
+
+bool Compact::pack(const Position &pos, const bool whiteToMove, PackedPosition &out) {
+    const uint64_t side = Bitboard::squareBit(sideCell(Bitboard::SIZE));
+    const uint64_t black = whiteToMove ? pos.opponent : pos.player;
+    const uint64_t white = whiteToMove ? pos.player : pos.opponent;
+    if (!((black | white) & side)) {
+        return false;
+    }
+
+    writeWord(out.data(), black);
+    writeWord(out.data() + 8, (white & ~side) | (whiteToMove ? side : 0));
+    return true;
+}
+
+bool Compact::unpack(const PackedPosition &packed, Position &pos, bool &whiteToMove) {
+    const uint64_t side = Bitboard::squareBit(sideCell(Bitboard::SIZE));
+    const uint64_t black = readWord(packed.data());
+    const uint64_t whiteWord = readWord(packed.data() + 8);
+    const uint64_t white = (whiteWord & ~side) | (~black & side);
+    if (black & white) {
+        return false;
+    }
+
+    whiteToMove = (whiteWord & side) != 0;
+    pos = whiteToMove ? Position{white, black} : Position{black, white};
+    return true;
+}
+
+std::string Compact::packBoard(const char *cells, const int size, const bool whiteToMove) {
+    const int count = size * size;
+    const size_t half = boardBytes(size) / 2;
+    const int side = sideCell(size);
+    if (cells[side] != 'b' && cells[side] != 'w') {
+        return "";
+    }
+
+    std::string packed(boardBytes(size), '\0');
+    for (int cell = 0; cell < count; cell++) {
+        if (cells[cell] == 'b') {
+            setBit(packed, 0, cell);
+        } else if (cells[cell] == 'w' && cell != side) {
+            setBit(packed, half, cell);
+        }
+    }
+    if (whiteToMove) {
+        setBit(packed, half, side);
+    }
+    return packed;
+}
+
+bool Compact::unpackBoard(const std::string &packed, char *cells, const int size, bool &whiteToMove) {
+    const int count = size * size;
+    const size_t half = boardBytes(size) / 2;
+    const int side = sideCell(size);
+    if (packed.size() != boardBytes(size)) {
+        return false;
+    }
+
+    for (int cell = 0; cell < count; cell++) {
+        if (cell != side && getBit(packed, 0, cell) && getBit(packed, half, cell)) {
+            return false;
+        }
+    }
+
+    for (int cell = 0; cell < count; cell++) {
+        if (getBit(packed, 0, cell)) {
+            cells[cell] = 'b';
+        } else if (cell == side || getBit(packed, half, cell)) {
+            cells[cell] = 'w';
+        } else {
+            cells[cell] = 's';
+        }
+    }
+    whiteToMove = getBit(packed, half, side);
+    return true;
+}
+
+std::string Compact::packMoves(const std::vector<int> &moves) {
+    std::string packed;
+    packed.reserve(moves.size());
+    for (const int square: moves) {
+        packed += static_cast<char>(square);
+    }
+    return packed;
+}
+
+bool Compact::unpackMoves(const std::string &packed, const int cellCount, std::vector<int> &moves) {
+    std::vector<int> unpacked;
+    unpacked.reserve(packed.size());
+    for (const char byte: packed) {
+        const int square = static_cast<uint8_t>(byte);
+        if (square >= cellCount) {
+            return false;
+        }
+        unpacked.push_back(square);
+    }
+    moves.swap(unpacked);
+    return true;
+}
+
+std::string Compact::toText(const std::string &bytes) {
+    std::string text;
+    text.reserve((bytes.size() * 4 + 2) / 3);
+
+    uint32_t buffer = 0;
+    int bits = 0;
+    for (const char byte: bytes) {
+        buffer = buffer << 8 | static_cast<uint8_t>(byte);
+        bits += 8;
+        while (bits >= 6) {
+            bits -= 6;
+            text += BASE64[(buffer >> bits) & 63];
+        }
+    }
+    if (bits > 0) {
+        text += BASE64[(buffer << (6 - bits)) & 63];
+    }
+    return text;
+}
+
+bool Compact::fromText(const std::string &text, std::string &bytes) {
+    // A single leftover character can't hold a whole byte
+    if (text.size() % 4 == 1) {
+        return false;
+    }
+
+    std::string decoded;
+    decoded.reserve(text.size() * 3 / 4);
+
+    uint32_t buffer = 0;
+    int bits = 0;
+    for (const char c: text) {
+        const int value = base64Value(c);
+        if (value < 0) {
+            return false;
+        }
+        buffer = buffer << 6 | static_cast<uint32_t>(value);
+        bits += 6;
+        if (bits >= 8) {
+            bits -= 8;
+            decoded += static_cast<char>((buffer >> bits) & 0xFF);
+        }
+    }
+
+    bytes.swap(decoded);
+    return true;
+}
+
+void Compact::writeGamesHeader(std::ostream &out) {
+    out.write(GAMES_MAGIC, sizeof(GAMES_MAGIC));
+}
+
+bool Compact::readGamesHeader(std::istream &in) {
+    const std::istream::pos_type start = in.tellg();
+    char magic[sizeof(GAMES_MAGIC)] = {};
+    if (in.read(magic, sizeof(magic)) && std::memcmp(magic, GAMES_MAGIC, sizeof(magic)) == 0) {
+        return true;
+    }
+
+    in.clear();
+    in.seekg(start);
+    return false;
+}
+
+void Compact::writeGame(std::ostream &out, const std::vector<int> &moves) {
+    const std::string packed = packMoves(moves);
+    out.put(static_cast<char>(packed.size()));
+    out.write(packed.data(), static_cast<std::streamsize>(packed.size()));
+}
+
+bool Compact::readGame(std::istream &in, std::vector<int> &moves) {
+    char count;
+    if (!in.get(count)) {
+        return false;
+    }
+
+    std::string packed(static_cast<uint8_t>(count), '\0');
+    if (!in.read(&packed[0], static_cast<std::streamsize>(packed.size()))) {
+        return false;
+    }
+    return unpackMoves(packed, Bitboard::SIZE * Bitboard::SIZE, moves);
+}
@@ -0,0 +1,327 @@
+//
+// EndgameCache.cpp - file mapping and lock-free slot access of the endgame cache
+//
+
+#include "../headers/EndgameCache.h"
+#include "../headers/Symmetry.h"
+
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+    constexpr char MAGIC[8] = {'R', 'V', 'E', 'G', 'C', '0', '0', '1'};
+    // 2: slots are homed by the Bitboard::hash with the mix finalizer
+    constexpr uint32_t VERSION = 2;
+
+    constexpr uint64_t CHECK_SALT = 0xD6E8FEB86659FD93ULL;
+
+    // Slots examined from the home slot of a position, four cache lines
+    constexpr size_t PROBE_WINDOW = 8;
+
+    constexpr size_t MIN_SLOTS = 1024;
+
+    // Tries of open() while another process sets the file up, SETUP_WAIT_MILLISECONDS apart
+    constexpr int OPEN_ATTEMPTS = 50;
+    constexpr int SETUP_WAIT_MILLISECONDS = 20;
+
+    struct FileHeader {
+        char magic[8];
+        uint32_t version;
+        uint32_t slotSize;
+        uint64_t slotCount;
+        uint8_t reserved[40];
+    };
+
+    static_assert(sizeof(FileHeader) == 64, "slots start on a cache line");
+
+    uint64_t encode(const int score, const int bestMove, const int empties) {
+        return static_cast<uint64_t>(score + 64) | static_cast<uint64_t>(bestMove) << 8
+               | static_cast<uint64_t>(empties) << 16;
+    }
+
+    int decodeScore(const uint64_t data) { return static_cast<int>(data & 0xFF) - 64; }
+
+    int decodeMove(const uint64_t data) { return static_cast<int>(data >> 8 & 0xFF); }
+
+    int decodeEmpties(const uint64_t data) { return static_cast<int>(data >> 16 & 0xFF); }
+
+    unsigned long processId() {
+#ifdef _WIN32
+        return GetCurrentProcessId();
+#else
+        return static_cast<unsigned long>(getpid());
+#endif
+    }
+}
+
+EndgameCache::~EndgameCache() {
+    close();
+}
+
+bool EndgameCache::open(const std::string &path, const size_t megabytes) {
+    static_assert(sizeof(Slot) == 32 && std::atomic<uint64_t>::is_always_lock_free,
+                  "slots are shared with other processes as plain words");
+    close();
+
+    size_t count = MIN_SLOTS;
+    while (count * 2 * sizeof(Slot) <= megabytes * 1024 * 1024) {
+        count *= 2;
+    }
+
+    for (int attempt = 0; attempt < OPEN_ATTEMPTS; attempt++) {
+        switch (mapFile(path)) {
+            case MapResult::MAPPED:
+                return true;
+            case MapResult::FAILED:
+                return false;
+            case MapResult::MISSING:
+                // Then map it, or the file of a process that created one at the same time
+                if (!createFile(path, count)) {
+                    return false;
+                }
+                break;
+            case MapResult::SETTING_UP:
+                std::this_thread::sleep_for(std::chrono::milliseconds(SETUP_WAIT_MILLISECONDS));
+                break;
+        }
+    }
+    return false;
+}
+
+bool EndgameCache::createFile(const std::string &path, const size_t count) {
+    static std::atomic<unsigned> created{0};
+    const std::string temporary = path + ".tmp" + std::to_string(processId()) + "-" + std::to_string(created++);
+    std::error_code error;
+
+    // The header is complete before the file appears under `path`
+    {
+        FileHeader header{};
+        std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+        header.version = VERSION;
+        header.slotSize = sizeof(Slot);
+        header.slotCount = count;
+
+        std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+        if (!out.write(reinterpret_cast<const char *>(&header), sizeof(header))) {
+            out.close();
+            std::filesystem::remove(temporary, error);
+            return false;
+        }
+    }
+
+    // Sparse zeros, which read as empty slots
+    std::filesystem::resize_file(temporary, sizeof(FileHeader) + count * sizeof(Slot), error);
+    if (error) {
+        std::filesystem::remove(temporary, error);
+        return false;
+    }
+
+    // A hard link never replaces a cache another process created meanwhile; then that one is used
+    std::filesystem::create_hard_link(temporary, path, error);
+    if (error && !std::filesystem::exists(path)) {
+        // File systems without hard links
+        std::filesystem::rename(temporary, path, error);
+        if (error) {
+            std::filesystem::remove(temporary, error);
+            return false;
+        }
+    }
+    std::filesystem::remove(temporary, error);
+    return true;
+}
+
+EndgameCache::MapResult EndgameCache::mapFile(const std::string &path) {
+    size_t bytes;
+
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE,
+                              nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return GetLastError() == ERROR_FILE_NOT_FOUND ? MapResult::MISSING : MapResult::FAILED;
+    }
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size)) {
+        CloseHandle(file);
+        return MapResult::FAILED;
+    }
+    bytes = static_cast<size_t>(size.QuadPart);
+    if (bytes < sizeof(FileHeader)) {
+        CloseHandle(file);
+        return MapResult::SETTING_UP;
+    }
+
+    HANDLE map = CreateFileMappingA(file, nullptr, PAGE_READWRITE, 0, 0, nullptr);
+    void *view = map ? MapViewOfFile(map, FILE_MAP_ALL_ACCESS, 0, 0, bytes) : nullptr;
+    if (!view) {
+        if (map) {
+            CloseHandle(map);
+        }
+        CloseHandle(file);
+        return MapResult::FAILED;
+    }
+    fileHandle = file;
+    mapHandle = map;
+    mapping = view;
+#else
+    const int fd = ::open(path.c_str(), O_RDWR);
+    if (fd < 0) {
+        return errno == ENOENT ? MapResult::MISSING : MapResult::FAILED;
+    }
+
+    struct stat info {};
+    if (fstat(fd, &info) != 0) {
+        ::close(fd);
+        return MapResult::FAILED;
+    }
+    bytes = static_cast<size_t>(info.st_size);
+    if (bytes < sizeof(FileHeader)) {
+        ::close(fd);
+        return MapResult::SETTING_UP;
+    }
+
+    void *view = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (view == MAP_FAILED) {
+        return MapResult::FAILED;
+    }
+    mapping = view;
+#endif
+    mappedBytes = bytes;
+
+    auto *header = static_cast<FileHeader *>(mapping);
+    static constexpr char NO_MAGIC[sizeof(MAGIC)] = {};
+    if (std::memcmp(header->magic, NO_MAGIC, sizeof(MAGIC)) == 0) {
+        // Still being set up by an older build, which writes the header after sizing the file
+        close();
+        return MapResult::SETTING_UP;
+    }
+    if (std::memcmp(header->magic, MAGIC, sizeof(MAGIC)) != 0 || header->slotSize != sizeof(Slot)
+        || header->slotCount < MIN_SLOTS || (header->slotCount & (header->slotCount - 1)) != 0
+        || bytes != sizeof(FileHeader) + header->slotCount * sizeof(Slot)) {
+        close();
+        return MapResult::FAILED;
+    }
+
+    slotCount = header->slotCount;
+    slots = reinterpret_cast<Slot *>(static_cast<char *>(mapping) + sizeof(FileHeader));
+
+    if (header->version != VERSION) {
+        // Entries of an older version can't be found any more. Empty the file in place, since
+        // other processes may map it, and mark it current only once every slot is cleared
+        for (size_t i = 0; i < slotCount; i++) {
+            slots[i].check.store(0, std::memory_order_relaxed);
+            slots[i].data.store(0, std::memory_order_relaxed);
+            slots[i].opponent.store(0, std::memory_order_relaxed);
+            slots[i].player.store(0, std::memory_order_relaxed);
+        }
+        std::atomic_thread_fence(std::memory_order_release);
+        header->version = VERSION;
+    }
+    return MapResult::MAPPED;
+}
+
+void EndgameCache::close() {
+    if (!mapping) {
+        return;
+    }
+
+#ifdef _WIN32
+    UnmapViewOfFile(mapping);
+    CloseHandle(static_cast<HANDLE>(mapHandle));
+    CloseHandle(static_cast<HANDLE>(fileHandle));
+    mapHandle = fileHandle = nullptr;
+#else
+    munmap(mapping, mappedBytes);
+#endif
+
+    mapping = nullptr;
+    mappedBytes = 0;
+    slots = nullptr;
+    slotCount = 0;
+}
+
+bool EndgameCache::probe(const Position &pos, int &score, int *bestMove) const {
+    if (!slots) {
+        return false;
+    }
+
+    int transform;
+    const Position key = Symmetry::canonical(pos, transform);
+    const size_t home = Bitboard::hash(key);
+
+    for (size_t i = 0; i < PROBE_WINDOW; i++) {
+        const Slot &slot = slots[(home + i) & (slotCount - 1)];
+        const uint64_t player = slot.player.load(std::memory_order_relaxed);
+        const uint64_t opponent = slot.opponent.load(std::memory_order_relaxed);
+        const uint64_t data = slot.data.load(std::memory_order_relaxed);
+        const uint64_t check = slot.check.load(std::memory_order_relaxed);
+
+        if (player == key.player && opponent == key.opponent && check == (player ^ opponent ^ data ^ CHECK_SALT)) {
+            score = decodeScore(data);
+            if (bestMove) {
+                *bestMove = Symmetry::transformSquare(decodeMove(data), Symmetry::inverse(transform));
+            }
+            return true;
+        }
+    }
+    return false;
+}
+
+void EndgameCache::store(const Position &pos, const int score, const int bestMove) {
+    const int empties = Bitboard::empties(pos);
+    if (!slots || empties < MIN_EMPTIES) {
+        return;
+    }
+
+    int transform;
+    const Position key = Symmetry::canonical(pos, transform);
+    const uint64_t data = encode(score, Symmetry::transformSquare(bestMove, transform), empties);
+    const size_t home = Bitboard::hash(key);
+
+    // An empty slot or the same position first, otherwise the cheapest entry to lose
+    Slot *target = nullptr;
+    int targetEmpties = 65;
+    for (size_t i = 0; i < PROBE_WINDOW; i++) {
+        Slot &slot = slots[(home + i) & (slotCount - 1)];
+        const uint64_t player = slot.player.load(std::memory_order_relaxed);
+        const uint64_t opponent = slot.opponent.load(std::memory_order_relaxed);
+        const uint64_t slotData = slot.data.load(std::memory_order_relaxed);
+        const uint64_t check = slot.check.load(std::memory_order_relaxed);
+
+        if (check != (player ^ opponent ^ slotData ^ CHECK_SALT)
+            || (player == key.player && opponent == key.opponent)) {
+            target = &slot;
+            targetEmpties = -1;
+            break;
+        }
+        if (decodeEmpties(slotData) < targetEmpties) {
+            target = &slot;
+            targetEmpties = decodeEmpties(slotData);
+        }
+    }
+
+    if (targetEmpties > empties) {
+        return;
+    }
+
+    target->player.store(key.player, std::memory_order_relaxed);
+    target->opponent.store(key.opponent, std::memory_order_relaxed);
+    target->data.store(data, std::memory_order_relaxed);
+    target->check.store(key.player ^ key.opponent ^ data ^ CHECK_SALT, std::memory_order_relaxed);
+}
@@ -0,0 +1,81 @@
+//
+// Evaluation.cpp - reading and writing evaluation weights files
+//
+
+#include "../headers/Evaluation.h"
+
+#include <fstream>
+#include <mutex>
+#include <sstream>
+
+std::string Evaluation::featureName(const int feature) {
+    switch (feature) {
+        case DISC:
+            return "disc";
+        case CORNER:
+            return "corner";
+        case EDGE:
+            return "edge";
+        default:
+            return "square" + std::to_string(feature - SQUARE_CLASS);
+    }
+}
+
+bool Evaluation::load(const std::string &path, Weights &weights) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    Weights loaded = weights;
+    std::string line;
+    while (std::getline(file, line)) {
+        const size_t comment = line.find('#');
+        if (comment != std::string::npos) {
+            line.erase(comment);
+        }
+
+        std::istringstream fields(line);
+        std::string name;
+        if (!(fields >> name)) {
+            continue;
+        }
+
+        int feature = 0;
+        while (feature < FEATURES && featureName(feature) != name) {
+            feature++;
+        }
+        if (feature == FEATURES || !(fields >> loaded.values[feature])) {
+            return false;
+        }
+    }
+
+    weights = loaded;
+    return true;
+}
+
+bool Evaluation::save(const std::string &path, const Weights &weights) {
+    std::ofstream file(path);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    file << "# Reversi evaluation weights, in evaluation units per disc difference\n";
+    for (int feature = 0; feature < FEATURES; feature++) {
+        file << featureName(feature) << ' ' << weights.values[feature] << '\n';
+    }
+    return static_cast<bool>(file);
+}
+
+const Evaluation::Weights &Evaluation::shared() {
+    static std::once_flag once;
+    static Weights weights;
+
+    std::call_once(once, []() {
+        Weights candidate;
+        if (load(DEFAULT_PATH, candidate)) {
+            weights = candidate;
+        }
+    });
+    return weights;
+}
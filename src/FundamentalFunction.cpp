@@ -4,13 +4,19 @@
 //
 
 #include "../headers/FundamentalFunction.h"
-#include <algorithm>
-#include <climits>
+#include "../headers/Bitboard.h"
+#include "../headers/GenericBoard.h"
+#include "../headers/MonteCarlo.h"
+#include "../headers/NeuralEvaluation.h"
+#include "../headers/Search.h"
+#include "../headers/SearchTrace.h"
 
 FundamentalFunction::FundamentalFunction() {
     aiDifficulty = AILevel::MEDIUM; // Default difficulty
 }
 
+FundamentalFunction::~FundamentalFunction() = default;
+
 /**
  * Initialize the board
  * This function haven't any input and return value.
@@ -22,10 +28,31 @@ void FundamentalFunction::initialize() {
         }
     }
 
-    board[3][3] = 'w';
-    board[3][4] = 'b';
-    board[4][3] = 'b';
-    board[4][4] = 'w';
+    const int center = BOARDLENGTH / 2;
+    board[center - 1][center - 1] = 'w';
+    board[center - 1][center] = 'b';
+    board[center][center - 1] = 'b';
+    board[center][center] = 'w';
+
+    version++;
+    markedMoves = BoardMask{};
+    markersKnown = true;
+    blackCount = 2;
+    whiteCount = 2;
+}
+
+void FundamentalFunction::boardChanged() {
+    version++;
+    markersKnown = false;
+
+    blackCount = 0;
+    whiteCount = 0;
+    for (const auto &row: board) {
+        for (const char cell: row) {
+            blackCount += cell == 'b';
+            whiteCount += cell == 'w';
+        }
+    }
 }
 
 /**
@@ -33,83 +60,55 @@ void FundamentalFunction::initialize() {
  * @param isWhiteTurn Who should play next (true is white turn, false is black turn)
  */
 void FundamentalFunction::showPlayPlace(const bool isWhiteTurn) {
-    // a mean available place
-    const vector<vector<int> > directions = {
-        {-1, -1}, {0, -1}, {1, -1}, {1, 0},
-        {1, 1}, {0, 1}, {-1, 1}, {-1, 0}
-    };
+    const BoardMask moves = legalMoves(isWhiteTurn);
 
-    // change available point back to 's'
-    for (auto &i: board) {
-        for (char &j: i) {
-            if (j == 'a') {
-                j = 's';
-            }
-        }
+    // The marks already on the board are the right ones
+    if (markersKnown && markedMoves == moves) {
+        return;
     }
 
-    // Loop through all cells on the board
-    for (int y = 0; y < BOARDLENGTH; y++) {
-        for (int x = 0; x < BOARDLENGTH; x++) {
-            // If the current player is white (isWhiteTurn == true), look from white pieces
-            // If the current player is black (isWhiteTurn == false), look from black pieces
-            char targetPiece = isWhiteTurn ? 'w' : 'b';
-
-            // Only check from pieces of the current player's color
-            if (board[y][x] == targetPiece) {
-                // Check in all 8 directions
-                for (const vector<int> &dir: directions) {
-                    dedect(x, y, dir[0], dir[1], isWhiteTurn);
-                }
-            }
-        }
+    clearPlayPlace();
+    for (BoardMask rest = moves; rest; rest = BoardBits::withoutLowest(rest)) {
+        const int square = BoardBits::lowestSquare(rest);
+        board[square / BOARDLENGTH][square % BOARDLENGTH] = 'a';
     }
+    markedMoves = moves;
 }
 
-/**
- * Consider whether the step is available.
- * \param xPos, yPos, moveX, moveY, isWhiteTurn
- */
-void FundamentalFunction::dedect(const int xPos, const int yPos, const int moveX, const int moveY, const bool isWhiteTurn) {
-    bool found = false;
-    int newX = xPos;
-    int newY = yPos;
-
-    if (isWhiteTurn) {
-        while (true) {
-            newX += moveX;
-            newY += moveY;
-
-            if (newX < 0 || newX > 7 || newY < 0 || newY > 7) {
-                break;
-            }
-            if (board[newY][newX] == 'b') {
-                found = true;
-            } else if (board[newY][newX] == 's' && found) {
-                board[newY][newX] = 'a';
-                break;
-            } else {
-                break;
+void FundamentalFunction::clearPlayPlace() {
+    if (markersKnown) {
+        // A mark may since have been covered by the disc played there
+        for (BoardMask rest = markedMoves; rest; rest = BoardBits::withoutLowest(rest)) {
+            const int square = BoardBits::lowestSquare(rest);
+            char &cell = board[square / BOARDLENGTH][square % BOARDLENGTH];
+            if (cell == 'a') {
+                cell = 's';
             }
         }
     } else {
-        while (true) {
-            newX += moveX;
-            newY += moveY;
-
-            if (newX < 0 || newX > 7 || newY < 0 || newY > 7) {
-                break;
-            }
-            if (board[newY][newX] == 'w') {
-                found = true;
-            } else if (board[newY][newX] == 's' && found) {
-                board[newY][newX] = 'a';
-                break;
-            } else {
-                break;
+        // change available point back to 's'
+        for (auto &i: board) {
+            for (char &j: i) {
+                if (j == 'a') {
+                    j = 's';
+                }
             }
         }
     }
+
+    markedMoves = BoardMask{};
+    markersKnown = true;
+}
+
+BoardMask FundamentalFunction::legalMoves(const bool isWhiteTurn) {
+    MoveCache &cache = moveCache[isWhiteTurn ? 1 : 0];
+    if (cache.version != version) {
+        using Board = GenericBoard<BOARDLENGTH>;
+        const Board::Pos pos = Board::fromBoard(board, isWhiteTurn);
+        cache.moves = Board::getMoves(pos.player, pos.opponent);
+        cache.version = version;
+    }
+    return cache.moves;
 }
 
 /**
@@ -117,10 +116,11 @@ void FundamentalFunction::dedect(const int xPos, const int yPos, const int moveX
  * This function haven't any input and return value.
  */
 void FundamentalFunction::display() const {
-    cout << "-----------------\n";
+    const string rule(2 * BOARDLENGTH + 1, '-');
+    cout << rule << "\n";
 
     for (auto i: board) {
-        for (int j = 0; j < 8; j++) {
+        for (int j = 0; j < BOARDLENGTH; j++) {
             cout << "|";
 
             if (i[j] == 's') {
@@ -134,7 +134,7 @@ void FundamentalFunction::display() const {
             }
         }
 
-        cout << "|\n-----------------\n";
+        cout << "|\n" << rule << "\n";
     }
 }
 
@@ -147,13 +147,17 @@ void FundamentalFunction::display() const {
  * \param isWhiteTurn this variable is to check this chess color.
  */
 void FundamentalFunction::turnOver(int xPos, int yPos, bool isWhiteTurn) {
+    // The disc at (xPos, yPos) was just placed, so the legal moves are stale either way
+    version++;
+    int flipped = 0;
+
     //cout << "*" << board[yPos][xPos] << endl;
     // searching centered on the white chess.
     if (isWhiteTurn) {
         // find the line of following eligible from the eight direstion of current chess.
         for (int i = -1; i <= 1; i++) {
             for (int j = -1; j <= 1; j++) {
-                if ((yPos + i) >= 0 && (yPos + i) < 8 && (xPos + j) >= 0 && (xPos + j) < 8) {
+                if ((yPos + i) >= 0 && (yPos + i) < BOARDLENGTH && (xPos + j) >= 0 && (xPos + j) < BOARDLENGTH) {
                     if (board[yPos + i][xPos + j] == 'b') {
                         int findPointX = j, findPointY = i;
                         int findLine = 0;
@@ -162,8 +166,8 @@ void FundamentalFunction::turnOver(int xPos, int yPos, bool isWhiteTurn) {
                         while (board[yPos + findPointY][xPos + findPointX] == 'b') {
                             findPointX += j;
                             findPointY += i;
-                            if ((yPos + findPointY) < 0 || (yPos + findPointY) >= 8 || (xPos + findPointX) < 0 || (
-                                    xPos + findPointX) >= 8) {
+                            if ((yPos + findPointY) < 0 || (yPos + findPointY) >= BOARDLENGTH || (xPos + findPointX) < 0 || (
+                                    xPos + findPointX) >= BOARDLENGTH) {
                                 findLine = 0;
                                 break;
                             }
@@ -184,6 +188,7 @@ void FundamentalFunction::turnOver(int xPos, int yPos, bool isWhiteTurn) {
                             int startPointY = yPos;
                             int startPointX = xPos;
                             while (startPointY != (yPos + findPointY) || startPointX != (xPos + findPointX)) {
+                                flipped += board[startPointY][startPointX] == 'b';
                                 board[startPointY][startPointX] = 'w';
                                 startPointY += i;
                                 startPointX += j;
@@ -200,7 +205,7 @@ void FundamentalFunction::turnOver(int xPos, int yPos, bool isWhiteTurn) {
         // find the line of following eligible from the eight direstion of current chess.
         for (int i = -1; i <= 1; i++) {
             for (int j = -1; j <= 1; j++) {
-                if ((yPos + i) >= 0 && (yPos + i) < 8 && (xPos + j) >= 0 && (xPos + j) < 8) {
+                if ((yPos + i) >= 0 && (yPos + i) < BOARDLENGTH && (xPos + j) >= 0 && (xPos + j) < BOARDLENGTH) {
                     if (board[yPos + i][xPos + j] == 'w') {
                         int findPointX = j, findPointY = i;
                         int findLine = 0;
@@ -209,8 +214,8 @@ void FundamentalFunction::turnOver(int xPos, int yPos, bool isWhiteTurn) {
                         while (board[yPos + findPointY][xPos + findPointX] == 'w') {
                             findPointX += j;
                             findPointY += i;
-                            if ((yPos + findPointY) < 0 || (yPos + findPointY) >= 8 || (xPos + findPointX) < 0 || (
-                                    xPos + findPointX) >= 8) {
+                            if ((yPos + findPointY) < 0 || (yPos + findPointY) >= BOARDLENGTH || (xPos + findPointX) < 0 || (
+                                    xPos + findPointX) >= BOARDLENGTH) {
                                 findLine = 0;
                                 break;
                             }
@@ -233,6 +238,7 @@ void FundamentalFunction::turnOver(int xPos, int yPos, bool isWhiteTurn) {
                             int startPointX = xPos;
                             //cout << startPointX << " " << startPointY << " " << xPos + findPointX << " " << yPos + findPointY << endl;
                             while (startPointY != (yPos + findPointY) || startPointX != (xPos + findPointX)) {
+                                flipped += board[startPointY][startPointX] == 'w';
                                 board[startPointY][startPointX] = 'b';
                                 startPointY += i;
                                 startPointX += j;
@@ -245,6 +251,12 @@ void FundamentalFunction::turnOver(int xPos, int yPos, bool isWhiteTurn) {
             }
         }
     }
+
+    // The placed disc plus every flipped one change hands
+    int &mover = isWhiteTurn ? whiteCount : blackCount;
+    int &other = isWhiteTurn ? blackCount : whiteCount;
+    mover += flipped + 1;
+    other -= flipped;
 }
 
 bool FundamentalFunction::checkWin(bool isWhiteTurn) {
@@ -253,246 +265,110 @@ bool FundamentalFunction::checkWin(bool isWhiteTurn) {
 
 // Enhanced AI with different difficulty levels
 std::pair<int, int> FundamentalFunction::AIPlayChess() {
-    // 找到所有標記為 'a' 的可用移動位置
-    std::vector<std::pair<int, int>> availableMoves;
-
-    for (int y = 0; y < BOARDLENGTH; y++) {
-        for (int x = 0; x < BOARDLENGTH; x++) {
-            if (board[y][x] == 'a') {
-                availableMoves.emplace_back(x, y);
-            }
-        }
-    }
-
-    // 如果沒有可用移動，返回 (-1, -1)
-    if (availableMoves.empty()) {
-        return {-1, -1};
-    }
-
-    // Use different AI strategies based on difficulty
-    switch (aiDifficulty) {
-        case AILevel::EASY:
-            return getEasyAIMove(availableMoves);
-        case AILevel::MEDIUM:
-            return getMediumAIMove(availableMoves);
-        case AILevel::HARD:
-            return getHardAIMove(availableMoves);
-        default:
-            return getMediumAIMove(availableMoves);
-    }
-}
-
-// Easy AI - looks ahead 3 moves
-std::pair<int, int> FundamentalFunction::getEasyAIMove(const std::vector<std::pair<int, int>>& availableMoves) {
-    int bestScore = INT_MIN;
-    std::pair<int, int> bestMove = availableMoves[0];
-
-    for (const auto& move : availableMoves) {
-        // Make a copy of the board
-        char tempBoard[BOARDLENGTH][BOARDLENGTH];
-        copyBoard(tempBoard, board);
-
-        // Make the move
-        makeMove(move.first, move.second, true);
-
-        // Evaluate using minimax with depth 3
-        int score = minimax(3, false, INT_MIN, INT_MAX);
-
-        // Restore board
-        copyBoard(board, tempBoard);
-
-        if (score > bestScore) {
-            bestScore = score;
-            bestMove = move;
-        }
-    }
-
-    return bestMove;
-}
-
-// Medium AI - looks ahead 5 moves
-std::pair<int, int> FundamentalFunction::getMediumAIMove(const std::vector<std::pair<int, int>>& availableMoves) {
-    int bestScore = INT_MIN;
-    std::pair<int, int> bestMove = availableMoves[0];
-
-    for (const auto& move : availableMoves) {
-        // Make a copy of the board
-        char tempBoard[BOARDLENGTH][BOARDLENGTH];
-        copyBoard(tempBoard, board);
-
-        // Make the move
-        makeMove(move.first, move.second, true);
-
-        // Evaluate using minimax with depth 5
-        int score = minimax(5, false, INT_MIN, INT_MAX);
-
-        // Restore board
-        copyBoard(board, tempBoard);
-
-        if (score > bestScore) {
-            bestScore = score;
-            bestMove = move;
-        }
-    }
-
-    return bestMove;
+    return chooseMove(TimeBudget());
 }
 
-// Hard AI - looks ahead 7 moves
-std::pair<int, int> FundamentalFunction::getHardAIMove(const std::vector<std::pair<int, int>>& availableMoves) {
-    int bestScore = INT_MIN;
-    std::pair<int, int> bestMove = availableMoves[0];
-
-    for (const auto& move : availableMoves) {
-        // Make a copy of the board
-        char tempBoard[BOARDLENGTH][BOARDLENGTH];
-        copyBoard(tempBoard, board);
-
-        // Make the move
-        makeMove(move.first, move.second, true);
-
-        // Evaluate using minimax with depth 7
-        int score = minimax(7, false, INT_MIN, INT_MAX);
+std::pair<int, int> FundamentalFunction::AIPlayChess(const double remainingSeconds, const int remainingChances) {
+    const int empties = getEmptyCount();
 
-        // Restore board
-        copyBoard(board, tempBoard);
-
-        if (score > bestScore) {
-            bestScore = score;
-            bestMove = move;
-        }
-    }
+    using Board = GenericBoard<BOARDLENGTH>;
+    const Board::Pos pos = Board::fromBoard(board, true);
+    const int legalMoves = BoardBits::popcount(Board::getMoves(pos.player, pos.opponent));
 
-    return bestMove;
+    return chooseMove(TimeManager::allocate(remainingSeconds, remainingChances, empties, legalMoves));
 }
 
-// Minimax algorithm with alpha-beta pruning
-int FundamentalFunction::minimax(int depth, bool isMaximizing, int alpha, int beta) {
-    if (depth == 0) {
-        return evaluateBoard();
-    }
-
-    std::vector<std::pair<int, int>> moves = getValidMoves(isMaximizing);
+std::pair<int, int> FundamentalFunction::chooseMove(const TimeBudget &budget) {
+    // The AI always plays white
+    using Board = GenericBoard<BOARDLENGTH>;
+    const Board::Pos pos = Board::fromBoard(board, true);
 
-    if (moves.empty()) {
-        return evaluateBoard();
+    // 如果沒有可用移動，返回 (-1, -1)
+    const BoardMask moves = Board::getMoves(pos.player, pos.opponent);
+    if (!moves) {
+        return {-1, -1};
     }
 
-    if (isMaximizing) {
-        int maxEval = INT_MIN;
-        for (const auto& move : moves) {
-            char tempBoard[BOARDLENGTH][BOARDLENGTH];
-            copyBoard(tempBoard, board);
-
-            makeMove(move.first, move.second, true);
-            int eval = minimax(depth - 1, false, alpha, beta);
-
-            copyBoard(board, tempBoard);
-
-            maxEval = std::max(maxEval, eval);
-            alpha = std::max(alpha, eval);
-
-            if (beta <= alpha) {
-                break; // Alpha-beta pruning
-            }
+    int square;
+    if (budget.instant || BoardBits::popcount(moves) == 1) {
+        square = BoardBits::lowestSquare(moves);
+#if REVERSI_BOARD_SIZE == 8
+    } else if (aiDifficulty == AILevel::MCTS) {
+        if (!monteCarlo) {
+            monteCarlo = std::make_unique<MonteCarloSearch>();
         }
-        return maxEval;
+        MonteCarloLimits limits;
+        limits.seconds = budget.maximum > 0.0 ? std::min(MCTS_SECONDS_PER_MOVE, budget.maximum)
+                                              : MCTS_SECONDS_PER_MOVE;
+        square = monteCarlo->search(pos, limits);
+#endif
     } else {
-        int minEval = INT_MAX;
-        for (const auto& move : moves) {
-            char tempBoard[BOARDLENGTH][BOARDLENGTH];
-            copyBoard(tempBoard, board);
-
-            makeMove(move.first, move.second, false);
-            int eval = minimax(depth - 1, true, alpha, beta);
-
-            copyBoard(board, tempBoard);
-
-            minEval = std::min(minEval, eval);
-            beta = std::min(beta, eval);
-
-            if (beta <= alpha) {
-                break; // Alpha-beta pruning
-            }
+        if (!search) {
+            search = std::make_unique<GenericSearch<BOARDLENGTH> >();
         }
-        return minEval;
-    }
-}
-
-// Board evaluation function
-int FundamentalFunction::evaluateBoard() {
-    int whiteCount = 0;
-    int blackCount = 0;
-
-    // Count pieces
-    for (int y = 0; y < BOARDLENGTH; y++) {
-        for (int x = 0; x < BOARDLENGTH; x++) {
-            if (board[y][x] == 'w') {
-                whiteCount++;
-                // Give extra points for corner positions
-                if ((x == 0 || x == 7) && (y == 0 || y == 7)) {
-                    whiteCount += 10;
-                }
-                // Give points for edge positions
-                else if (x == 0 || x == 7 || y == 0 || y == 7) {
-                    whiteCount += 2;
-                }
-            } else if (board[y][x] == 'b') {
-                blackCount++;
-                // Give extra points for corner positions
-                if ((x == 0 || x == 7) && (y == 0 || y == 7)) {
-                    blackCount += 10;
-                }
-                // Give points for edge positions
-                else if (x == 0 || x == 7 || y == 0 || y == 7) {
-                    blackCount += 2;
+        // Other sizes have no network or MCTS; those levels search as deep as Hard+
+        const AIProfile &level = profile(aiDifficulty);
+#if REVERSI_BOARD_SIZE == 8
+        search->setNetwork(aiDifficulty == AILevel::HARD_PLUS ? NeuralNetwork::shared() : nullptr);
+#endif
+        search->setTimeBudget(budget);
+        search->setNodeLimit(level.nodeBudget);
+
+        // Noise and blunders choose among every move, so all of them are scored exactly
+        const bool wantAll = level.noise > 0 || level.blunderChance > 0.0;
+        const std::vector<MoveScore> scored = search->analyze(pos, level.maxDepth, wantAll ? 0 : 1);
+        square = scored.front().square;
+
+        if (blunders(level)) {
+            square = scored[1 + aiRandom() % (scored.size() - 1)].square;
+        } else if (level.noise > 0) {
+            std::normal_distribution<double> noise(0.0, level.noise);
+            double best = -GenericSearch<BOARDLENGTH>::INF;
+            for (const MoveScore &move: scored) {
+                const double score = move.score + noise(aiRandom);
+                if (score > best) {
+                    best = score;
+                    square = move.square;
                 }
             }
         }
     }
 
-    return whiteCount - blackCount;
+    SEARCH_TRACE_FLUSH();
+    return {square % BOARDLENGTH, square / BOARDLENGTH};
 }
 
-// Helper functions
-void FundamentalFunction::copyBoard(char dest[BOARDLENGTH][BOARDLENGTH],
-                                  const char src[BOARDLENGTH][BOARDLENGTH]) {
-    for (int y = 0; y < BOARDLENGTH; y++) {
-        for (int x = 0; x < BOARDLENGTH; x++) {
-            dest[y][x] = src[y][x];
-        }
-    }
-}
-
-void FundamentalFunction::makeMove(int x, int y, bool isWhite) {
-    board[y][x] = isWhite ? 'w' : 'b';
-    turnOver(x, y, isWhite);
-}
-
-std::vector<std::pair<int, int>> FundamentalFunction::getValidMoves(bool isWhiteTurn) {
-    // Clear previous available moves
-    for (int y = 0; y < BOARDLENGTH; y++) {
-        for (int x = 0; x < BOARDLENGTH; x++) {
-            if (board[y][x] == 'a') {
-                board[y][x] = 's';
-            }
-        }
-    }
-
-    showPlayPlace(isWhiteTurn);
+/**
+ * Plies searched for each level: the AI's own move plus 3/5/7/9 moves of
+ * lookahead, stopped early by the node budget. About 3 million nodes are
+ * searched per second, so Easy and Medium stay well under 0.1 s a move and
+ * Hard under a second. The network of Hard+ costs more per node, so it gets
+ * twice the nodes of Hard.
+ */
+const AIProfile &FundamentalFunction::profile(const AILevel level) {
+    static constexpr AIProfile EASY{4, 20000, 8, 0.10};
+    static constexpr AIProfile MEDIUM{6, 150000, 3, 0.03};
+    static constexpr AIProfile HARD{8, 1500000, 0, 0.0};
+    static constexpr AIProfile HARD_PLUS{10, 3000000, 0, 0.0};
 
-    std::vector<std::pair<int, int>> moves;
-    for (int y = 0; y < BOARDLENGTH; y++) {
-        for (int x = 0; x < BOARDLENGTH; x++) {
-            if (board[y][x] == 'a') {
-                moves.emplace_back(x, y);
-            }
-        }
+    switch (level) {
+        case AILevel::EASY:
+            return EASY;
+        case AILevel::HARD:
+            return HARD;
+        case AILevel::HARD_PLUS:
+        case AILevel::MCTS:
+            return HARD_PLUS;
+        case AILevel::MEDIUM:
+        default:
+            return MEDIUM;
     }
+}
 
-    return moves;
+bool FundamentalFunction::blunders(const AIProfile &level) {
+    return level.blunderChance > 0.0 && std::bernoulli_distribution(level.blunderChance)(aiRandom);
 }
 
 void FundamentalFunction::setAIDifficulty(AILevel level) {
     aiDifficulty = level;
-}
\ No newline at end of file
+}
@@ -3,9 +3,15 @@
 //
 
 #include "../headers/GameScreen.h"
+#include "../headers/Compact.h"
 #include "../headers/MainMenu.h"
 #include "../headers/VictoryScreen.h"
 
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <sstream>
+
 void GameScreen::init() {
     // Initialize game logic
     gameLogic.initialize();
@@ -70,7 +76,7 @@ void GameScreen::init() {
     currentPlayerText.setPosition({WINDOW_WIDTH / 2.0f - 80.0f, 110.0f});
 
     // Set up game board
-    boardBackground.setSize({cellSize * 8, cellSize * 8});
+    boardBackground.setSize({cellSize * BOARDLENGTH, cellSize * BOARDLENGTH});
     boardBackground.setPosition({boardX, boardY});
     boardBackground.setFillColor(sf::Color(30, 120, 30)); // Dark green
     boardBackground.setOutlineThickness(2.0f);
@@ -101,6 +107,10 @@ void GameScreen::init() {
     // Set up board pieces
     updateBoardPieces();
 
+    moveTree.reset(takeSnapshot());
+    playedMove = PlayedMove();
+    updateLineButton();
+
     // Start transition in
     startTransitionIn();
 }
@@ -127,11 +137,28 @@ void GameScreen::handleInput(sf::Event event) {
         saveCurrentGame();
         return;
     }
+    // Check button clicks ( Hint )
+    if (hintButton.wasClicked()) {
+        showHints = !showHints;
+        hintButton.setText(showHints ? "Hint: On" : "Hint");
+        refreshHints();
+        return;
+    }
     // Check button clicks ( Undo )
-    if (undoButton.wasClicked() && !moveHistory.empty()) {
+    if (undoButton.wasClicked() && moveTree.getCurrentNode().parent != MoveTree<Snapshot>::NONE) {
         undoMove();
         return;
     }
+    // Check button clicks ( Redo )
+    if (redoButton.wasClicked() && moveTree.next(moveTree.getCurrent()) != MoveTree<Snapshot>::NONE) {
+        redoMove();
+        return;
+    }
+    // Check button clicks ( Line )
+    if (lineButton.wasClicked()) {
+        nextLine();
+        return;
+    }
 
     // Check board clicks
     if (gameOver) {
@@ -150,7 +177,7 @@ void GameScreen::handleInput(sf::Event event) {
     int boardCoordY = static_cast<int>((mousePos.y - boardY) / cellSize);
 
     // Check if click is within board bounds
-    if (boardCoordX < 0 || boardCoordX >= 8 || boardCoordY < 0 || boardCoordY >= 8) {
+    if (boardCoordX < 0 || boardCoordX >= BOARDLENGTH || boardCoordY < 0 || boardCoordY >= BOARDLENGTH) {
         return;
     }
 
@@ -159,22 +186,13 @@ void GameScreen::handleInput(sf::Event event) {
         // Move was successful, check if game over conditions
         updateScores();
         checkGameOver();
+        recordSnapshot();
     }
 }
 // New method to check if the game should end
 void GameScreen::checkGameOver() {
     // Check if current player has valid moves
-    bool currentPlayerHasValidMoves = false;
-    for (auto &y: gameLogic.board) {
-        for (char x: y) {
-            if (x == 'a') {
-                currentPlayerHasValidMoves = true;
-                break;
-            }
-        }
-        if (currentPlayerHasValidMoves)
-            break;
-    }
+    const bool currentPlayerHasValidMoves = gameLogic.hasMoves(isWhiteTurn);
 
     if (!currentPlayerHasValidMoves) {
         // Current player has no valid moves, switch to other player
@@ -182,17 +200,7 @@ void GameScreen::checkGameOver() {
         gameLogic.showPlayPlace(isWhiteTurn);
 
         // Check if other player has valid moves
-        bool otherPlayerHasValidMoves = false;
-        for (auto &y: gameLogic.board) {
-            for (char x: y) {
-                if (x == 'a') {
-                    otherPlayerHasValidMoves = true;
-                    break;
-                }
-            }
-            if (otherPlayerHasValidMoves)
-                break;
-        }
+        const bool otherPlayerHasValidMoves = gameLogic.hasMoves(isWhiteTurn);
 
         if (!otherPlayerHasValidMoves) {
             // Both players have no valid moves, game is over
@@ -217,6 +225,7 @@ void GameScreen::checkGameOver() {
 // New method to handle end game conditions
 void GameScreen::endGame() {
     gameOver = true;
+    updateScores();
 
     // Determine winner based on score
     std::string winner;
@@ -245,6 +254,10 @@ void GameScreen::endGame() {
 void checkGameOver();
 
 void GameScreen::update(float deltaTime) {
+    // The frame after an AI move also measured its search, which must not run the human's clock
+    deltaTime = std::max(0.0f, deltaTime - pendingSearchTime);
+    pendingSearchTime = 0.0f;
+
     GameState::update(deltaTime);
 
     // 存檔按鈕文字恢復邏輯
@@ -259,8 +272,11 @@ void GameScreen::update(float deltaTime) {
 
     // Update buttons
     undoButton.update(window);
+    redoButton.update(window);
+    lineButton.update(window);
     menuButton.update(window);
     saveButton.update(window);
+    hintButton.update(window);
 
     if (vsComputer && isWhiteTurn && !gameOver) {
         if (!aiThinking) {
@@ -275,17 +291,7 @@ void GameScreen::update(float deltaTime) {
                 aiThinking = false;
 
                 // After AI move, check if human player has valid moves
-                bool humanHasValidMoves = false;
-                for (auto &y: gameLogic.board) {
-                    for (char x: y) {
-                        if (x == 'a') {
-                            humanHasValidMoves = true;
-                            break;
-                        }
-                    }
-                    if (humanHasValidMoves)
-                        break;
-                }
+                const bool humanHasValidMoves = gameLogic.hasMoves(false);
 
                 // If human has no valid moves, it's still AI's turn
                 if (!humanHasValidMoves && !gameOver) {
@@ -300,11 +306,18 @@ void GameScreen::update(float deltaTime) {
                     aiThinking = true;
                     aiThinkingTime = 0.0f;
                 }
+                recordSnapshot();
             }
         }
     }
 
 
+    // Keep the hint overlay in step with the board; results arrive from the analysis thread
+    refreshHints();
+    if (hintAnalyzer.poll(hintInfo, hintVersion)) {
+        updateHintTexts();
+    }
+
     // Update timers if game is not over
     if (!gameOver) {
         player1Timer.update(deltaTime);
@@ -320,7 +333,7 @@ void GameScreen::update(float deltaTime) {
     int boardCoordY = static_cast<int>((mousePos.y - boardY) / cellSize);
 
     // Check if mouse is over the board
-    if (boardCoordX >= 0 && boardCoordX < 8 && boardCoordY >= 0 && boardCoordY < 8) {
+    if (boardCoordX >= 0 && boardCoordX < BOARDLENGTH && boardCoordY >= 0 && boardCoordY < BOARDLENGTH) {
         selectedX = boardCoordX;
         selectedY = boardCoordY;
     } else {
@@ -342,18 +355,18 @@ void GameScreen::render() {
                         timerBackground2.getFillColor(), 10.0f);
 
     // Draw board grid
-    for (int y = 0; y <= 8; y++) {
+    for (int y = 0; y <= BOARDLENGTH; y++) {
         sf::Vertex hLine[] = {
             sf::Vertex{sf::Vector2f(boardX, boardY + y * cellSize), sf::Color::Black},
-            sf::Vertex{sf::Vector2f(boardX + 8 * cellSize, boardY + y * cellSize), sf::Color::Black}
+            sf::Vertex{sf::Vector2f(boardX + BOARDLENGTH * cellSize, boardY + y * cellSize), sf::Color::Black}
         };
         window.draw(hLine, 2, sf::PrimitiveType::Lines);
     }
 
-    for (int x = 0; x <= 8; x++) {
+    for (int x = 0; x <= BOARDLENGTH; x++) {
         sf::Vertex vLine[] = {
             sf::Vertex{sf::Vector2f(boardX + x * cellSize, boardY), sf::Color::Black},
-            sf::Vertex{sf::Vector2f(boardX + x * cellSize, boardY + 8 * cellSize), sf::Color::Black}
+            sf::Vertex{sf::Vector2f(boardX + x * cellSize, boardY + BOARDLENGTH * cellSize), sf::Color::Black}
         };
         window.draw(vLine, 2, sf::PrimitiveType::Lines);
     }
@@ -369,6 +382,11 @@ void GameScreen::render() {
         window.draw(piece);
     }
 
+    // Draw move-hint scores
+    for (const auto &hintText: hintTexts) {
+        window.draw(hintText);
+    }
+
     // Draw text elements
     window.draw(titleText);
     window.draw(player1Text);
@@ -382,26 +400,20 @@ void GameScreen::render() {
 
     // Draw buttons
     undoButton.draw(window);
+    redoButton.draw(window);
+    lineButton.draw(window);
     menuButton.draw(window);
     saveButton.draw(window);
+    hintButton.draw(window);
 
     // Draw transition overlay
     renderTransition();
 }
 
 void GameScreen::updateScores() {
-    player1Score = 0;
-    player2Score = 0;
-
-    for (auto &y: gameLogic.board) {
-        for (char x: y) {
-            if (x == 'b') {
-                player1Score++;
-            } else if (x == 'w') {
-                player2Score++;
-            }
-        }
-    }
+    // Kept by the game logic from the flips of each move
+    player1Score = gameLogic.getBlackCount();
+    player2Score = gameLogic.getWhiteCount();
 
     scoreText.setString("Score: " + std::to_string(player1Score) + " - " + std::to_string(player2Score));
 }
@@ -409,8 +421,8 @@ void GameScreen::updateScores() {
 void GameScreen::updateBoardPieces() {
     pieces.clear();
 
-    for (int y = 0; y < 8; y++) {
-        for (int x = 0; x < 8; x++) {
+    for (int y = 0; y < BOARDLENGTH; y++) {
+        for (int x = 0; x < BOARDLENGTH; x++) {
             if (gameLogic.board[y][x] == 'b' || gameLogic.board[y][x] == 'w') {
                 sf::CircleShape piece(cellSize / 2.0f - 5.0f);
 
@@ -446,9 +458,7 @@ bool GameScreen::makeMove(int x, int y) {
 
     // Place the piece
     gameLogic.board[y][x] = isWhiteTurn ? 'w' : 'b';
-
-    // Record the move for undo
-    moveHistory.push_back({x, y, isWhiteTurn});
+    playedMove = {x, y, isWhiteTurn};
 
     // Play sound
     placeSound.setBuffer(resources->getSoundBuffer("place"));
@@ -474,17 +484,7 @@ bool GameScreen::makeMove(int x, int y) {
 
     // Check if the next player has valid moves
     // This is the key part we need to add
-    bool nextPlayerHasValidMoves = false;
-    for (auto &y: gameLogic.board) {
-        for (char x: y) {
-            if (x == 'a') {
-                nextPlayerHasValidMoves = true;
-                break;
-            }
-        }
-        if (nextPlayerHasValidMoves)
-            break;
-    }
+    const bool nextPlayerHasValidMoves = gameLogic.hasMoves(isWhiteTurn);
 
     // If next player has no valid moves, switch back to the other player
     if (!nextPlayerHasValidMoves) {
@@ -503,17 +503,7 @@ bool GameScreen::makeMove(int x, int y) {
         updateBoardPieces();
 
         // Check if the original player also has no moves - would be game over
-        bool originalPlayerHasValidMoves = false;
-        for (auto &y: gameLogic.board) {
-            for (char x: y) {
-                if (x == 'a') {
-                    originalPlayerHasValidMoves = true;
-                    break;
-                }
-            }
-            if (originalPlayerHasValidMoves)
-                break;
-        }
+        const bool originalPlayerHasValidMoves = gameLogic.hasMoves(isWhiteTurn);
 
         if (!originalPlayerHasValidMoves) {
             // Both players have no moves, game over
@@ -547,44 +537,169 @@ void GameScreen::checkTimers() {
 }
 
 void GameScreen::undoMove() {
-    if (moveHistory.empty()) {
+    using Tree = MoveTree<Snapshot>;
+    int target = moveTree.getCurrentNode().parent;
+    if (target == Tree::NONE) {
         return;
     }
 
-    // Get the last move
-    Move lastMove = moveHistory.back();
-    moveHistory.pop_back();
+    // Against the computer go back past its replies to the last human move
+    if (vsComputer) {
+        while (moveTree[target].parent != Tree::NONE && moveTree[target].state.isWhiteTurn) {
+            target = moveTree[target].parent;
+        }
+    }
 
-    // Reset the game board to the previous state
-    gameLogic.initialize();
+    restoreSnapshot(target);
+}
 
-    // Replay all moves except the last one
-    for (const auto &move: moveHistory) {
-        gameLogic.board[move.y][move.x] = move.wasWhiteTurn ? 'w' : 'b';
-        gameLogic.turnOver(move.x, move.y, move.wasWhiteTurn);
+void GameScreen::redoMove() {
+    using Tree = MoveTree<Snapshot>;
+    int target = moveTree.next(moveTree.getCurrent());
+    if (target == Tree::NONE) {
+        return;
     }
 
-    // Set the current player
-    isWhiteTurn = lastMove.wasWhiteTurn;
-    currentPlayerText.setString("Current Turn: " + std::string(isWhiteTurn ? "White" : "Black"));
+    // Against the computer redo the human move together with the replies to it
+    if (vsComputer) {
+        while (moveTree[target].state.isWhiteTurn && !moveTree[target].state.gameOver
+               && moveTree.next(target) != Tree::NONE) {
+            target = moveTree.next(target);
+        }
+    }
 
-    // Show available moves
-    gameLogic.showPlayPlace(isWhiteTurn);
+    restoreSnapshot(target);
+}
 
-    // Update board pieces
-    updateBoardPieces();
+int GameScreen::variationNode() const {
+    // Against the computer the alternatives worth switching are the human's moves
+    int move = moveTree.getCurrent();
+    if (vsComputer) {
+        while (moveTree[move].parent != MoveTree<Snapshot>::NONE && moveTree[move].byWhite) {
+            move = moveTree[move].parent;
+        }
+    }
+    return move;
+}
 
-    // Update scores
-    updateScores();
+void GameScreen::updateLineButton() {
+    const int move = variationNode();
+    const int parent = moveTree[move].parent;
+    const size_t lines = parent == MoveTree<Snapshot>::NONE ? 1 : moveTree[parent].children.size();
+    lineButton.setText("Line " + std::to_string(moveTree.variation(move) + 1) + "/" + std::to_string(lines));
+}
+
+void GameScreen::nextLine() {
+    using Tree = MoveTree<Snapshot>;
+    const int move = variationNode();
+    int target = moveTree.nextSibling(move);
+    if (target == move) {
+        return;
+    }
+
+    // Follow the new line to where the human is to move again
+    if (vsComputer) {
+        while (moveTree[target].state.isWhiteTurn && !moveTree[target].state.gameOver
+               && moveTree.next(target) != Tree::NONE) {
+            target = moveTree.next(target);
+        }
+    }
+
+    restoreSnapshot(target);
+}
 
-    // Reset timers to correct players
+GameScreen::Snapshot GameScreen::takeSnapshot() const {
+    Snapshot snapshot{};
+    std::memcpy(snapshot.board, gameLogic.board, sizeof(snapshot.board));
+    snapshot.isWhiteTurn = isWhiteTurn;
+    snapshot.player1Score = player1Score;
+    snapshot.player2Score = player2Score;
+    snapshot.gameOver = gameOver;
+    return snapshot;
+}
+
+void GameScreen::recordSnapshot() {
+    if (playedMove.x < 0) {
+        // Only the turn changed (a pass), which belongs to the position already stored
+        moveTree.setCurrentState(takeSnapshot());
+        return;
+    }
+
+    moveTree.add(playedMove.x, playedMove.y, playedMove.byWhite, takeSnapshot());
+    playedMove = PlayedMove();
+    updateLineButton();
+}
+
+void GameScreen::restoreSnapshot(const int index) {
+    moveTree.enter(index);
+    const Snapshot &snapshot = moveTree[index].state;
+
+    std::memcpy(gameLogic.board, snapshot.board, sizeof(snapshot.board));
+    gameLogic.boardChanged();
+    isWhiteTurn = snapshot.isWhiteTurn;
+    gameOver = snapshot.gameOver;
+    player1Score = snapshot.player1Score;
+    player2Score = snapshot.player2Score;
+    scoreText.setString("Score: " + std::to_string(player1Score) + " - " + std::to_string(player2Score));
+
+    // A pending AI move belonged to the position that was left
+    aiThinking = false;
+    aiThinkingTime = 0.0f;
+
+    currentPlayerText.setString("Current Turn: " + std::string(isWhiteTurn ? "White" : "Black"));
+    updateBoardPieces();
+    updateLineButton();
+
+    // The side to move starts a fresh 30 seconds; chances already lost stay lost
+    player1Timer.reset();
+    player2Timer.reset();
     player1Timer.setPlayerTurn(!isWhiteTurn);
     player2Timer.setPlayerTurn(isWhiteTurn);
 }
 
+bool GameScreen::playSnapshot(const Snapshot &from, const int x, const int y, const bool byWhite, Snapshot &to) {
+    if (x < 0 || x >= BOARDLENGTH || y < 0 || y >= BOARDLENGTH || from.isWhiteTurn != byWhite
+        || from.board[y][x] != 'a') {
+        return false;
+    }
+
+    FundamentalFunction logic;
+    std::memcpy(logic.board, from.board, sizeof(logic.board));
+    logic.boardChanged();
+    logic.board[y][x] = byWhite ? 'w' : 'b';
+    logic.turnOver(x, y, byWhite);
+
+    // The same turn rules as makeMove(): pass back when the next player cannot move
+    to = Snapshot{};
+    to.isWhiteTurn = !byWhite;
+    to.gameOver = false;
+    if (!logic.hasMoves(to.isWhiteTurn)) {
+        to.isWhiteTurn = byWhite;
+        to.gameOver = !logic.hasMoves(to.isWhiteTurn);
+    }
+    logic.showPlayPlace(to.isWhiteTurn);
+
+    std::memcpy(to.board, logic.board, sizeof(to.board));
+    to.player1Score = logic.getBlackCount();
+    to.player2Score = logic.getWhiteCount();
+    return true;
+}
+
 void GameScreen::saveCurrentGame() {
+    // The start position on one line, then every move tried from it
+    std::ostringstream variations;
+    const Snapshot &root = moveTree[0].state;
+    const std::string packedRoot = Compact::packBoard(&root.board[0][0], BOARDLENGTH, root.isWhiteTurn);
+    if (packedRoot.empty()) {
+        variations << std::string(&root.board[0][0], sizeof(root.board)) << ' ' << root.isWhiteTurn << '\n';
+    } else {
+        variations << Compact::toText(packedRoot) << '\n';
+    }
+    moveTree.write(variations);
+
     const bool success = saveGameManager.saveGame(gameLogic, player1Name, player2Name, isWhiteTurn, vsComputer,
-                                            player1Timer.getRemainingChances(), player2Timer.getRemainingChances());
+                                            player1Timer.getRemainingChances(), player2Timer.getRemainingChances(),
+                                            variations.str());
 
     if (success) {
         sf::Sound saveSound(resources->getSoundBuffer("click"));
@@ -602,14 +717,15 @@ void GameScreen::saveCurrentGame() {
     }
 }
 
-void GameScreen::setLoadedGameData(const FundamentalFunction &loadedLogic, bool currentTurn, int player1Chances = 3,
-                                   int player2Chances = 3) {
+void GameScreen::setLoadedGameData(const FundamentalFunction &loadedLogic, bool currentTurn, int player1Chances,
+                                   int player2Chances, const std::string &moveTreeText) {
     // Copy the board state
     for (int y = 0; y < BOARDLENGTH; y++) {
         for (int x = 0; x < BOARDLENGTH; x++) {
             gameLogic.board[y][x] = loadedLogic.board[y][x];
         }
     }
+    gameLogic.boardChanged();
 
     if (vsComputer) {
         gameLogic.setAIDifficulty(aiDifficulty);
@@ -640,24 +756,51 @@ void GameScreen::setLoadedGameData(const FundamentalFunction &loadedLogic, bool
     // Show available moves for the current player
     gameLogic.showPlayPlace(isWhiteTurn);
     updateBoardPieces(); // Update again to show available moves
+
+    // Without saved variations the loaded position is as far back as undo goes
+    moveTree.reset(takeSnapshot());
+    playedMove = PlayedMove();
+
+    std::istringstream in(moveTreeText);
+    std::string rootBoard;
+    bool rootWhiteTurn = false;
+    std::string packedRoot;
+    FundamentalFunction rootLogic;
+
+    // The start position is packed with its side to move, or the raw cells and the side in older saves
+    bool rootRead = false;
+    if (in >> rootBoard) {
+        if (rootBoard.size() == sizeof(Snapshot::board)) {
+            std::memcpy(rootLogic.board, rootBoard.data(), sizeof(rootLogic.board));
+            rootRead = static_cast<bool>(in >> rootWhiteTurn);
+        } else {
+            rootRead = Compact::fromText(rootBoard, packedRoot)
+                       && Compact::unpackBoard(packedRoot, &rootLogic.board[0][0], BOARDLENGTH, rootWhiteTurn);
+        }
+    }
+
+    if (rootRead) {
+        rootLogic.boardChanged();
+        rootLogic.showPlayPlace(rootWhiteTurn);
+
+        Snapshot root{};
+        std::memcpy(root.board, rootLogic.board, sizeof(root.board));
+        root.isWhiteTurn = rootWhiteTurn;
+        root.player1Score = rootLogic.getBlackCount();
+        root.player2Score = rootLogic.getWhiteCount();
+
+        if (moveTree.read(in, root, playSnapshot)) {
+            restoreSnapshot(moveTree.getCurrent());
+        }
+    }
+    updateLineButton();
 }
 
 // Add to GameScreen.h (in public or private section, depending on your design)
 
 void GameScreen::makeAIMove() {
     // check ai valid move
-    bool hasValidMoves = false;
-
-    for (auto &y: gameLogic.board) {
-        for (char x: y) {
-            if (x == 'a') {
-                hasValidMoves = true;
-                break;
-            }
-        }
-        if (hasValidMoves)
-            break;
-    }
+    const bool hasValidMoves = gameLogic.hasMoves(true);
     // If no valid move change to black
     if (!hasValidMoves) {
         isWhiteTurn = false;
@@ -668,17 +811,7 @@ void GameScreen::makeAIMove() {
         updateBoardPieces();
 
         // Check if the human player also has no valid moves - would be game over
-        bool humanHasValidMoves = false;
-        for (auto &y: gameLogic.board) {
-            for (char x: y) {
-                if (x == 'a') {
-                    humanHasValidMoves = true;
-                    break;
-                }
-            }
-            if (humanHasValidMoves)
-                break;
-        }
+        const bool humanHasValidMoves = gameLogic.hasMoves(false);
 
         if (!humanHasValidMoves) {
             // Both players have no moves, game over
@@ -689,15 +822,19 @@ void GameScreen::makeAIMove() {
     }
     try {
         // 獲取 AI 的選擇移動
-        auto [moveX, moveY] = gameLogic.AIPlayChess();
+        const auto searchStart = std::chrono::steady_clock::now();
+        auto [moveX, moveY] = gameLogic.AIPlayChess(player2Timer.getRemainingTime(),
+                                                    player2Timer.getRemainingChances());
+        pendingSearchTime = std::chrono::duration<float>(std::chrono::steady_clock::now() - searchStart).count();
+
+        // 思考時間計入 AI 的計時器
+        player2Timer.update(pendingSearchTime);
 
         // 確保返回的坐標在有效範圍內
-        if (moveX >= 0 && moveX < 8 && moveY >= 0 && moveY < 8 && gameLogic.board[moveY][moveX] == 'a') {
+        if (moveX >= 0 && moveX < BOARDLENGTH && moveY >= 0 && moveY < BOARDLENGTH && gameLogic.board[moveY][moveX] == 'a') {
             // 放置棋子
             gameLogic.board[moveY][moveX] = 'w';
-
-            // 記錄移動用於撤銷
-            moveHistory.push_back({moveX, moveY, true});
+            playedMove = {moveX, moveY, true};
 
             // 播放聲音
             placeSound.setBuffer(resources->getSoundBuffer("place"));
@@ -757,3 +894,54 @@ void GameScreen::setAIDifficulty(const AILevel level) {
     aiDifficulty = level;
     gameLogic.setAIDifficulty(level);
 }
+
+void GameScreen::refreshHints() {
+    // No hints while the AI is to move or after the game ended
+    const bool wanted = showHints && !gameOver && !(vsComputer && isWhiteTurn);
+
+    if (!wanted) {
+        if (hintRunning) {
+            hintAnalyzer.stop();
+            hintRunning = false;
+        }
+        return;
+    }
+
+    const HintAnalyzer::Pos pos = GenericBoard<BOARDLENGTH>::fromBoard(gameLogic.board, isWhiteTurn);
+    if (hintRunning && pos == hintPosition) {
+        return;
+    }
+
+    hintPosition = pos;
+    hintRunning = true;
+    hintAnalyzer.start(pos, HINT_MAX_DEPTH);
+}
+
+void GameScreen::updateHintTexts() {
+    hintTexts.clear();
+
+    for (size_t i = 0; i < hintInfo.moves.size(); i++) {
+        const MoveScore &move = hintInfo.moves[i];
+
+        // Finished lines show the final disc margin, everything else the evaluation
+        std::string label;
+        if (Search::isFinalScore(move.score)) {
+            const int discs = Search::discDifference(move.score);
+            label = (discs > 0 ? "=+" : "=") + std::to_string(discs);
+        } else {
+            label = (move.score > 0 ? "+" : "") + std::to_string(move.score);
+        }
+
+        sf::Text text(resources->getFont("main"), label, 14);
+        text.setFillColor(i == 0 ? sf::Color(255, 215, 0) : sf::Color::White);
+        text.setOutlineThickness(1.0f);
+        text.setOutlineColor(sf::Color::Black);
+
+        const int x = move.square % BOARDLENGTH;
+        const int y = move.square / BOARDLENGTH;
+        text.setOrigin(text.getLocalBounds().getCenter());
+        text.setPosition({boardX + x * cellSize + cellSize / 2.0f, boardY + y * cellSize + cellSize / 2.0f});
+
+        hintTexts.push_back(text);
+    }
+}
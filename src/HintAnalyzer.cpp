@@ -0,0 +1,40 @@
+//
+// HintAnalyzer.cpp
+//
+
+#include "../headers/HintAnalyzer.h"
+
+void HintAnalyzer::start(const Pos &pos, const int maxDepth) {
+    stop();
+    search.clearStop();
+
+    worker = std::thread([this, pos, maxDepth]() {
+        search.analyze(pos, maxDepth, 0, [this](const AnalysisInfo &info) {
+            std::lock_guard<std::mutex> lock(mutex);
+            latest = info;
+            latestVersion++;
+        });
+    });
+}
+
+void HintAnalyzer::stop() {
+    search.requestStop();
+    if (worker.joinable()) {
+        worker.join();
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    latest = AnalysisInfo();
+    latestVersion++;
+}
+
+bool HintAnalyzer::poll(AnalysisInfo &info, unsigned &version) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (version == latestVersion) {
+        return false;
+    }
+
+    info = latest;
+    version = latestVersion;
+    return true;
+}
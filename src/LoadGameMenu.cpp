@@ -105,9 +105,10 @@ void LoadGameMenu::loadGame(const std::string& savePath) {
     std::string player1Name, player2Name;
     bool isWhiteTurn, vsComputer;
     int player1Chances = 0, player2Chances = 0;
+    std::string variations;
 
     // Load the game data
-    if (saveGameManager.loadGame(savePath, gameLogic, player1Name, player2Name, isWhiteTurn, vsComputer, player1Chances, player2Chances)) {
+    if (saveGameManager.loadGame(savePath, gameLogic, player1Name, player2Name, isWhiteTurn, vsComputer, player1Chances, player2Chances, &variations)) {
         auto gameScreen = std::make_shared<GameScreen>(
             window, stateChangeCallback, player1Name, player2Name, vsComputer);
 
@@ -115,7 +116,7 @@ void LoadGameMenu::loadGame(const std::string& savePath) {
         gameScreen->init();
 
         // We need to pass the loaded game data to the GameScreen
-        gameScreen->setLoadedGameData(gameLogic, isWhiteTurn, player1Chances, player2Chances);
+        gameScreen->setLoadedGameData(gameLogic, isWhiteTurn, player1Chances, player2Chances, variations);
 
         startTransitionTo(gameScreen);
     }
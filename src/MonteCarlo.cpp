@@ -0,0 +1,289 @@
+//
+// MonteCarlo.cpp - UCT tree growth with virtual loss, batched playouts and subtree reuse
+//
+
+#include "../headers/MonteCarlo.h"
+#include "../headers/BatchPlayout.h"
+#include "../headers/Search.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <thread>
+#include <vector>
+
+namespace {
+    // UCT exploration constant for rewards between 0 and 1
+    constexpr double EXPLORATION = 1.0;
+
+    // Visits added while a thread is below a node, steering other threads elsewhere
+    constexpr int32_t VIRTUAL_LOSS = 3;
+
+    // Iterations between clock reads
+    constexpr int TIME_CHECK_INTERVAL = 16;
+}
+
+MonteCarloSearch::MonteCarloSearch(const size_t nodeCapacity) : nodes(nodeCapacity) {
+}
+
+MonteCarloSearch::~MonteCarloSearch() = default;
+
+void MonteCarloSearch::clear() {
+    nodes.reset();
+    root = NO_CHILDREN;
+}
+
+int32_t MonteCarloSearch::allocate(const int count) {
+    const int32_t first = nodes.allocate(count);
+    if (first < 0) {
+        return -1;
+    }
+
+    for (int32_t i = first; i < first + count; i++) {
+        Node &node = nodes[i];
+        node.visits.store(0, std::memory_order_relaxed);
+        node.wins.store(0, std::memory_order_relaxed);
+        node.firstChild = NO_CHILDREN;
+        node.childCount = 0;
+        node.move = Bitboard::PASS;
+        node.state.store(UNEXPANDED, std::memory_order_relaxed);
+    }
+    return first;
+}
+
+bool MonteCarloSearch::expand(const int32_t index) {
+    Node &node = nodes[index];
+    uint8_t expected = UNEXPANDED;
+    if (!node.state.compare_exchange_strong(expected, EXPANDING, std::memory_order_acquire)) {
+        return false;
+    }
+
+    uint64_t moves = Bitboard::getMoves(node.pos.player, node.pos.opponent);
+    const int count = moves ? Bitboard::popcount(moves) : 1;
+    const int32_t first = allocate(count);
+
+    if (first >= 0) {
+        if (!moves) {
+            nodes[first].pos = Bitboard::pass(node.pos);
+        }
+        for (int i = 0; moves; i++) {
+            const int square = Bitboard::lowestSquare(moves);
+            moves &= moves - 1;
+            nodes[first + i].pos = Bitboard::play(node.pos, square,
+                                                  Bitboard::getFlips(node.pos.player, node.pos.opponent, square));
+            nodes[first + i].move = static_cast<uint8_t>(square);
+        }
+        node.firstChild = first;
+        node.childCount = static_cast<uint8_t>(count);
+    }
+
+    // With a full pool the node stays a leaf (no children) for the rest of the search
+    node.state.store(EXPANDED, std::memory_order_release);
+    return first >= 0;
+}
+
+int32_t MonteCarloSearch::selectChild(const Node &node) const {
+    const double logVisits = std::log(std::max(1, node.visits.load(std::memory_order_relaxed)));
+
+    int32_t best = node.firstChild;
+    double bestValue = -1.0;
+    for (int32_t child = node.firstChild; child < node.firstChild + node.childCount; child++) {
+        const int32_t visits = nodes[child].visits.load(std::memory_order_relaxed);
+        if (visits == 0) {
+            return child;
+        }
+
+        const double value = nodes[child].wins.load(std::memory_order_relaxed) / (2.0 * visits)
+                             + EXPLORATION * std::sqrt(logVisits / visits);
+        if (value > bestValue) {
+            bestValue = value;
+            best = child;
+        }
+    }
+    return best;
+}
+
+int MonteCarloSearch::descend(int32_t *path, bool &terminal) {
+    int length = 0;
+    int32_t current = root;
+    path[length++] = current;
+    nodes[current].visits.fetch_add(VIRTUAL_LOSS, std::memory_order_relaxed);
+
+    terminal = false;
+    for (;;) {
+        Node &node = nodes[current];
+        if (node.state.load(std::memory_order_acquire) != EXPANDED) {
+            if (!Bitboard::getMoves(node.pos.player, node.pos.opponent)
+                && !Bitboard::getMoves(node.pos.opponent, node.pos.player)) {
+                terminal = true;
+                break;
+            }
+            // Leaves are expanded on their second visit, a first visit only plays out
+            if (node.visits.load(std::memory_order_relaxed) <= VIRTUAL_LOSS || !expand(current)) {
+                break;
+            }
+        }
+        if (node.childCount == 0 || length == MAX_PATH) {
+            break;
+        }
+
+        current = selectChild(node);
+        path[length++] = current;
+        nodes[current].visits.fetch_add(VIRTUAL_LOSS, std::memory_order_relaxed);
+    }
+    return length;
+}
+
+void MonteCarloSearch::backup(const int32_t *path, const int length, const int result) {
+    // Half points for the player who moved into the leaf, i.e. not the side to move there
+    int reward = result > 0 ? 0 : result < 0 ? 2 : 1;
+    for (int i = length - 1; i >= 0; i--) {
+        Node &node = nodes[path[i]];
+        node.wins.fetch_add(reward, std::memory_order_relaxed);
+        node.visits.fetch_add(1 - VIRTUAL_LOSS, std::memory_order_relaxed);
+        reward = 2 - reward;
+    }
+}
+
+void MonteCarloSearch::iterate(uint64_t &rng, int32_t (*paths)[MAX_PATH]) {
+    int lengths[BatchPlayout::LANES];
+    int results[BatchPlayout::LANES];
+    Position leaves[BatchPlayout::LANES];
+    int leafLane[BatchPlayout::LANES];
+    int leafCount = 0;
+
+    // Virtual losses keep the selections of one batch apart
+    for (int lane = 0; lane < BatchPlayout::LANES; lane++) {
+        bool terminal;
+        lengths[lane] = descend(paths[lane], terminal);
+        const Position &leaf = nodes[paths[lane][lengths[lane] - 1]].pos;
+        if (terminal) {
+            results[lane] = Search::discDifference(Search::finalScore(leaf));
+        } else {
+            leaves[leafCount] = leaf;
+            leafLane[leafCount++] = lane;
+        }
+    }
+
+    int playoutResults[BatchPlayout::LANES];
+    BatchPlayout::run(leaves, leafCount, playoutResults, rng);
+    for (int i = 0; i < leafCount; i++) {
+        results[leafLane[i]] = playoutResults[i];
+    }
+
+    for (int lane = 0; lane < BatchPlayout::LANES; lane++) {
+        backup(paths[lane], lengths[lane], results[lane]);
+    }
+}
+
+int32_t MonteCarloSearch::findReusable(const Position &pos) const {
+    if (root < 0) {
+        return -1;
+    }
+    if (nodes[root].pos == pos) {
+        return root;
+    }
+
+    // Our move, then the opponent's reply
+    const Node &rootNode = nodes[root];
+    if (rootNode.state.load(std::memory_order_acquire) != EXPANDED) {
+        return -1;
+    }
+    for (int32_t child = rootNode.firstChild; child < rootNode.firstChild + rootNode.childCount; child++) {
+        const Node &childNode = nodes[child];
+        if (childNode.pos == pos) {
+            return child;
+        }
+        if (childNode.state.load(std::memory_order_acquire) != EXPANDED) {
+            continue;
+        }
+        for (int32_t grandchild = childNode.firstChild;
+             grandchild < childNode.firstChild + childNode.childCount; grandchild++) {
+            if (nodes[grandchild].pos == pos) {
+                return grandchild;
+            }
+        }
+    }
+    return -1;
+}
+
+int MonteCarloSearch::search(const Position &pos, const MonteCarloLimits &limits) {
+    stopRequested.store(false, std::memory_order_relaxed);
+    playouts = 0;
+
+    // Keep the known subtree unless the pool is already half used
+    const int32_t reusable = findReusable(pos);
+    if (reusable >= 0 && getNodesUsed() < nodes.getCapacity() / 2) {
+        root = reusable;
+    } else {
+        clear();
+        root = allocate(1);
+        nodes[root].pos = pos;
+    }
+
+    if (!Bitboard::getMoves(pos.player, pos.opponent)) {
+        return Bitboard::PASS;
+    }
+
+    int threads = limits.threads > 0 ? limits.threads : static_cast<int>(std::thread::hardware_concurrency());
+    threads = std::max(1, threads);
+
+    const bool timed = limits.seconds > 0.0;
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::duration_cast<
+                              std::chrono::steady_clock::duration>(std::chrono::duration<double>(limits.seconds));
+
+    auto worker = [&](const int threadIndex) {
+        uint64_t rng = 0x9E3779B97F4A7C15ULL * (threadIndex + 1) ^ reinterpret_cast<uintptr_t>(this);
+        int32_t paths[BatchPlayout::LANES][MAX_PATH];
+
+        for (int i = 1;; i++) {
+            iterate(rng, paths);
+            const uint64_t done = playouts += BatchPlayout::LANES;
+
+            if (stopRequested.load(std::memory_order_relaxed) || (limits.playouts && done >= limits.playouts)) {
+                break;
+            }
+            if (timed && i % TIME_CHECK_INTERVAL == 0 && std::chrono::steady_clock::now() >= deadline) {
+                break;
+            }
+        }
+    };
+
+    std::vector<std::thread> helpers;
+    for (int t = 1; t < threads; t++) {
+        helpers.emplace_back(worker, t);
+    }
+    worker(0);
+    for (std::thread &helper: helpers) {
+        helper.join();
+    }
+
+    // Most visited move is the most robust choice
+    const Node &rootNode = nodes[root];
+    int bestMove = Bitboard::PASS;
+    int32_t bestVisits = -1;
+    if (rootNode.state.load(std::memory_order_acquire) == EXPANDED) {
+        for (int32_t child = rootNode.firstChild; child < rootNode.firstChild + rootNode.childCount; child++) {
+            if (nodes[child].visits > bestVisits) {
+                bestVisits = nodes[child].visits;
+                bestMove = nodes[child].move;
+            }
+        }
+    }
+
+    // A pool exhausted before the root was expanded still needs a legal answer
+    if (bestMove == Bitboard::PASS) {
+        bestMove = Bitboard::lowestSquare(Bitboard::getMoves(pos.player, pos.opponent));
+    }
+    return bestMove;
+}
+
+double MonteCarloSearch::getRootWinRate() const {
+    if (root < 0) {
+        return 0.5;
+    }
+
+    const Node &node = nodes[root];
+    const int32_t visits = node.visits.load(std::memory_order_relaxed);
+    return visits > 0 ? 1.0 - node.wins.load(std::memory_order_relaxed) / (2.0 * visits) : 0.5;
+}
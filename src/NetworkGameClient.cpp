@@ -21,8 +21,8 @@ void NetworkGameClient::handleInput(const sf::Event event) {
                 int boardCoordX = static_cast<int>((mousePos.x - boardX) / cellSize);
                 int boardCoordY = static_cast<int>((mousePos.y - boardY) / cellSize);
 
-                if (boardCoordX >= 0 && boardCoordX < 8 &&
-                    boardCoordY >= 0 && boardCoordY < 8) {
+                if (boardCoordX >= 0 && boardCoordX < BOARD_SIZE &&
+                    boardCoordY >= 0 && boardCoordY < BOARD_SIZE) {
                     if (gameLogic.board[boardCoordY][boardCoordX] == 'a') {
                         sendMove(boardCoordX, boardCoordY);
                     }
@@ -5,6 +5,7 @@
 
 #include "../headers/NetworkGameScreen.h"
 #include "../headers/MainMenu.h"
+#include "../headers/Compact.h"
 #include <iostream>
 
 // 如果你需要完整的.cpp实现文件，这里是主要的方法实现
@@ -16,10 +17,11 @@ void NetworkGameScreen::initializeBoard() {
     }
 
     // 初始化中央四个子
-    board[3][3] = 'W';
-    board[3][4] = 'B';
-    board[4][3] = 'B';
-    board[4][4] = 'W';
+    const int center = BOARD_SIZE / 2;
+    board[center - 1][center - 1] = 'W';
+    board[center - 1][center] = 'B';
+    board[center][center - 1] = 'B';
+    board[center][center] = 'W';
 }
 
 void NetworkGameScreen::connectToServer() {
@@ -88,6 +90,10 @@ void NetworkGameScreen::handleServerMessage(const std::string& message) {
         // BOARD:棋盘数据
         updateBoardFromServer(message.substr(6));
     }
+    else if (message.compare(0, 9, "POSITION:") == 0) {
+        // POSITION:压缩棋盘 (Compact.h 的 base64url 格式)
+        updateBoardFromPacked(message.substr(9));
+    }
     else if (message == "YOUR_TURN") {
         isMyTurn = true;
         std::cout << "轮到你了!" << std::endl;
@@ -114,19 +120,35 @@ void NetworkGameScreen::handleServerMessage(const std::string& message) {
 }
 
 void NetworkGameScreen::updateBoardFromServer(const std::string& boardData) {
-    if (boardData.length() != 64) {
+    if (boardData.length() != BOARD_SIZE * BOARD_SIZE) {
         std::cout << "收到无效的棋盘数据，长度: " << boardData.length() << std::endl;
         return;
     }
     
     std::cout << "更新棋盘状态" << std::endl;
-    for (int y = 0; y < 8; y++) {
-        for (int x = 0; x < 8; x++) {
-            board[y][x] = boardData[y * 8 + x];
+    for (int y = 0; y < BOARD_SIZE; y++) {
+        for (int x = 0; x < BOARD_SIZE; x++) {
+            board[y][x] = boardData[y * BOARD_SIZE + x];
         }
     }
 }
 
+void NetworkGameScreen::updateBoardFromPacked(const std::string& text) {
+    std::string packed;
+    char cells[BOARD_SIZE * BOARD_SIZE];
+    bool whiteToMove;
+    if (!Compact::fromText(text, packed) || !Compact::unpackBoard(packed, cells, BOARD_SIZE, whiteToMove)) {
+        std::cout << "收到无效的压缩棋盘: " << text << std::endl;
+        return;
+    }
+
+    std::string boardData(cells, BOARD_SIZE * BOARD_SIZE);
+    for (char& cell : boardData) {
+        cell = cell == 'b' ? 'B' : cell == 'w' ? 'W' : 's';
+    }
+    updateBoardFromServer(boardData);
+}
+
 void NetworkGameScreen::handleGameEnd(const std::string& message) {
     gameOver = true;
     
@@ -178,8 +200,8 @@ void NetworkGameScreen::handleInput(sf::Event event) {
                 int boardCoordX = static_cast<int>((mousePos.x - boardX) / cellSize);
                 int boardCoordY = static_cast<int>((mousePos.y - boardY) / cellSize);
 
-                if (boardCoordX >= 0 && boardCoordX < 8 &&
-                    boardCoordY >= 0 && boardCoordY < 8) {
+                if (boardCoordX >= 0 && boardCoordX < BOARD_SIZE &&
+                    boardCoordY >= 0 && boardCoordY < BOARD_SIZE) {
                     sendMove(boardCoordX, boardCoordY);
                     }
             }
@@ -0,0 +1,213 @@
+//
+// NeuralEvaluation.cpp - weight loading and int8 inference, AVX2 when the CPU has it
+//
+
+#include "../headers/NeuralEvaluation.h"
+#include "../headers/CpuFeatures.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+
+#if defined(REVERSI_AVX2)
+#include <immintrin.h>
+#endif
+
+namespace {
+    constexpr char NNUE_MAGIC[8] = {'R', 'V', 'N', 'N', 'U', 'E', '0', '1'};
+    constexpr uint32_t NNUE_VERSION = 1;
+
+    template<typename T>
+    bool readArray(FILE *file, T *data, const size_t count) {
+        return fread(data, sizeof(T), count, file) == count;
+    }
+
+    // acc[i] += weights[i]
+    void addWeights(int16_t *acc, const int16_t *weights) {
+        for (int i = 0; i < NeuralNetwork::HIDDEN; i++) {
+            acc[i] = static_cast<int16_t>(acc[i] + weights[i]);
+        }
+    }
+
+    // acc[i] += add[i] - sub[i]
+    void moveWeights(int16_t *acc, const int16_t *add, const int16_t *sub) {
+        for (int i = 0; i < NeuralNetwork::HIDDEN; i++) {
+            acc[i] = static_cast<int16_t>(acc[i] + add[i] - sub[i]);
+        }
+    }
+
+    // Clip int16 accumulator values to [0, ACTIVATION_MAX] bytes, keeping their order
+    void clipAccumulatorScalar(const int16_t *acc, uint8_t *out) {
+        for (int i = 0; i < NeuralNetwork::HIDDEN; i++) {
+            out[i] = static_cast<uint8_t>(std::clamp<int>(acc[i], 0, NeuralNetwork::ACTIVATION_MAX));
+        }
+    }
+
+    // Sum of in[i] * weights[i]; `count` is a multiple of 32 and both arrays are 32-byte aligned
+    int32_t dotScalar(const uint8_t *in, const int8_t *weights, const int count) {
+        int32_t sum = 0;
+        for (int i = 0; i < count; i++) {
+            sum += in[i] * weights[i];
+        }
+        return sum;
+    }
+
+#if defined(REVERSI_AVX2)
+    REVERSI_TARGET_AVX2 void clipAccumulatorAvx2(const int16_t *acc, uint8_t *out) {
+        const __m256i zero = _mm256_setzero_si256();
+        const __m256i max = _mm256_set1_epi16(NeuralNetwork::ACTIVATION_MAX);
+        for (int i = 0; i < NeuralNetwork::HIDDEN; i += 32) {
+            const __m256i a = _mm256_min_epi16(_mm256_max_epi16(
+                _mm256_load_si256(reinterpret_cast<const __m256i *>(acc + i)), zero), max);
+            const __m256i b = _mm256_min_epi16(_mm256_max_epi16(
+                _mm256_load_si256(reinterpret_cast<const __m256i *>(acc + i + 16)), zero), max);
+            // packus works per 128-bit lane, the permute restores the element order
+            const __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi16(a, b), 0xD8);
+            _mm256_store_si256(reinterpret_cast<__m256i *>(out + i), packed);
+        }
+    }
+
+    REVERSI_TARGET_AVX2 int32_t dotAvx2(const uint8_t *in, const int8_t *weights, const int count) {
+        const __m256i ones = _mm256_set1_epi16(1);
+        __m256i sum = _mm256_setzero_si256();
+        for (int i = 0; i < count; i += 32) {
+            const __m256i x = _mm256_load_si256(reinterpret_cast<const __m256i *>(in + i));
+            const __m256i w = _mm256_load_si256(reinterpret_cast<const __m256i *>(weights + i));
+            // Inputs are at most 127, so the pairwise int16 sums cannot saturate
+            sum = _mm256_add_epi32(sum, _mm256_madd_epi16(_mm256_maddubs_epi16(x, w), ones));
+        }
+        __m128i half = _mm_add_epi32(_mm256_castsi256_si128(sum), _mm256_extracti128_si256(sum, 1));
+        half = _mm_add_epi32(half, _mm_shuffle_epi32(half, 0x4E));
+        half = _mm_add_epi32(half, _mm_shuffle_epi32(half, 0xB1));
+        return _mm_cvtsi128_si32(half);
+    }
+#endif
+
+    void clipAccumulator(const int16_t *acc, uint8_t *out) {
+#if defined(REVERSI_AVX2)
+        if (CpuFeatures::avx2()) {
+            clipAccumulatorAvx2(acc, out);
+            return;
+        }
+#endif
+        clipAccumulatorScalar(acc, out);
+    }
+
+    int32_t dot(const uint8_t *in, const int8_t *weights, const int count) {
+#if defined(REVERSI_AVX2)
+        if (CpuFeatures::avx2()) {
+            return dotAvx2(in, weights, count);
+        }
+#endif
+        return dotScalar(in, weights, count);
+    }
+
+    uint8_t clipDense(const int32_t sum) {
+        return static_cast<uint8_t>(std::clamp(sum >> NeuralNetwork::WEIGHT_SHIFT, 0, NeuralNetwork::ACTIVATION_MAX));
+    }
+}
+
+bool NeuralNetwork::load(const std::string &path) {
+    loaded = false;
+
+    FILE *file = fopen(path.c_str(), "rb");
+    if (!file) {
+        return false;
+    }
+
+    char magic[8];
+    uint32_t header[4];
+    bool ok = readArray(file, magic, 8) && readArray(file, header, 4)
+              && std::memcmp(magic, NNUE_MAGIC, sizeof(magic)) == 0 && header[0] == NNUE_VERSION
+              && header[1] == HIDDEN && header[2] == LAYER1 && header[3] == LAYER2;
+
+    ok = ok && readArray(file, &inputWeights[0][0], INPUTS * HIDDEN)
+         && readArray(file, inputBias, HIDDEN)
+         && readArray(file, &layer1Weights[0][0], LAYER1 * 2 * HIDDEN)
+         && readArray(file, layer1Bias, LAYER1)
+         && readArray(file, &layer2Weights[0][0], LAYER2 * LAYER1)
+         && readArray(file, layer2Bias, LAYER2)
+         && readArray(file, outputWeights, LAYER2)
+         && readArray(file, &outputBias, 1);
+
+    fclose(file);
+    loaded = ok;
+    return ok;
+}
+
+void NeuralNetwork::refresh(const Position &pos, Accumulator &acc) const {
+    std::memcpy(acc.own, inputBias, sizeof(acc.own));
+    std::memcpy(acc.other, inputBias, sizeof(acc.other));
+
+    for (uint64_t discs = pos.player; discs; discs &= discs - 1) {
+        const int square = Bitboard::lowestSquare(discs);
+        addWeights(acc.own, inputWeights[square]);
+        addWeights(acc.other, inputWeights[64 + square]);
+    }
+    for (uint64_t discs = pos.opponent; discs; discs &= discs - 1) {
+        const int square = Bitboard::lowestSquare(discs);
+        addWeights(acc.own, inputWeights[64 + square]);
+        addWeights(acc.other, inputWeights[square]);
+    }
+}
+
+void NeuralNetwork::update(const Accumulator &parent, Accumulator &child, const int square,
+                           const uint64_t flips) const {
+    // The opponent moves next: its view becomes `own`, the mover's view becomes `other`
+    std::memcpy(child.own, parent.other, sizeof(child.own));
+    std::memcpy(child.other, parent.own, sizeof(child.other));
+
+    addWeights(child.own, inputWeights[64 + square]);
+    addWeights(child.other, inputWeights[square]);
+
+    for (uint64_t discs = flips; discs; discs &= discs - 1) {
+        const int flipped = Bitboard::lowestSquare(discs);
+        moveWeights(child.own, inputWeights[64 + flipped], inputWeights[flipped]);
+        moveWeights(child.other, inputWeights[flipped], inputWeights[64 + flipped]);
+    }
+}
+
+void NeuralNetwork::pass(const Accumulator &parent, Accumulator &child) {
+    std::memcpy(child.own, parent.other, sizeof(child.own));
+    std::memcpy(child.other, parent.own, sizeof(child.other));
+}
+
+int NeuralNetwork::evaluate(const Accumulator &acc) const {
+    alignas(32) uint8_t input[2 * HIDDEN];
+    alignas(32) uint8_t hidden1[LAYER1];
+    alignas(32) uint8_t hidden2[LAYER2];
+
+    clipAccumulator(acc.own, input);
+    clipAccumulator(acc.other, input + HIDDEN);
+
+    for (int i = 0; i < LAYER1; i++) {
+        hidden1[i] = clipDense(layer1Bias[i] + dot(input, layer1Weights[i], 2 * HIDDEN));
+    }
+    for (int i = 0; i < LAYER2; i++) {
+        hidden2[i] = clipDense(layer2Bias[i] + dot(hidden1, layer2Weights[i], LAYER1));
+    }
+
+    const int32_t output = outputBias + dot(hidden2, outputWeights, LAYER2);
+    return std::clamp(output / OUTPUT_DIVISOR, -MAX_EVAL, MAX_EVAL);
+}
+
+int NeuralNetwork::evaluate(const Position &pos) const {
+    Accumulator acc;
+    refresh(pos, acc);
+    return evaluate(acc);
+}
+
+const NeuralNetwork *NeuralNetwork::shared() {
+    static std::once_flag once;
+    static std::unique_ptr<NeuralNetwork> network;
+
+    std::call_once(once, []() {
+        auto candidate = std::make_unique<NeuralNetwork>();
+        if (candidate->load(DEFAULT_PATH)) {
+            network = std::move(candidate);
+        }
+    });
+    return network.get();
+}
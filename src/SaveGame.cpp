@@ -3,15 +3,24 @@
 //
 
 #include "../headers/SaveGame.h"
+#include "../headers/Compact.h"
 #include "../headers/FundamentalFunction.h"
 
+#include <algorithm>
+
+namespace {
+    // Line holding the packed board (see Compact.h)
+    const std::string POSITION_PREFIX = "position ";
+}
+
 bool SaveGame::saveGame(const FundamentalFunction &gameLogic,
                         const std::string &player1Name,
                         const std::string &player2Name,
                         bool isWhiteTurn,
                         bool vsComputer,
                         int player1Chance,
-                        int player2Chance) {
+                        int player2Chance,
+                        const std::string &variations) {
     // Create filename based on timestamp
     std::time_t currentTime = std::time(nullptr);
     std::string filename = "saves/" + std::to_string(currentTime) + ".txt";
@@ -34,12 +43,22 @@ bool SaveGame::saveGame(const FundamentalFunction &gameLogic,
     saveFile << player1Chance << '\n';
     saveFile << player2Chance << '\n';
 
-    // Save board state
-    for (auto y: gameLogic.board) {
-        for (int x = 0; x < BOARDLENGTH; x++) {
-            saveFile << y[x];
+    // Save board state: packed on one line, as rows only if the centre is empty
+    const std::string packed = Compact::packBoard(&gameLogic.board[0][0], BOARDLENGTH, isWhiteTurn);
+    if (!packed.empty()) {
+        saveFile << POSITION_PREFIX << Compact::toText(packed) << '\n';
+    } else {
+        for (auto y: gameLogic.board) {
+            for (int x = 0; x < BOARDLENGTH; x++) {
+                saveFile << y[x];
+            }
+            saveFile << '\n';
         }
-        saveFile << '\n';
+    }
+
+    // Move tree, absent from older saves
+    if (!variations.empty()) {
+        saveFile << "variations\n" << variations;
     }
 
     saveFile.flush();
@@ -54,7 +73,8 @@ bool SaveGame::loadGame(const std::string &filename,
                         bool &isWhiteTurn,
                         bool &vsComputer,
                         int &player1Chance,
-                        int &player2Chance
+                        int &player2Chance,
+                        std::string *variations
 ) {
     std::ifstream loadFile(filename);
     if (!loadFile.is_open()) {
@@ -80,20 +100,48 @@ bool SaveGame::loadGame(const std::string &filename,
     isWhiteTurn = (whiteStr == "true");
     vsComputer = (computerStr == "true");
 
-    // Load board state
+    // Load board state, packed or as the rows older saves have
     std::string line;
-    int y = 0;
-    while (y < BOARDLENGTH && std::getline(loadFile, line)) {
-        for (int x = 0; x < BOARDLENGTH && x < line.length(); x++) {
-            gameLogic.board[y][x] = line[x];
+    std::string packed;
+    char cells[BOARDLENGTH][BOARDLENGTH];
+    bool packedWhiteTurn;
+    if (!std::getline(loadFile, line)) {
+        return false;
+    }
+    if (line.compare(0, POSITION_PREFIX.size(), POSITION_PREFIX) == 0) {
+        if (!Compact::fromText(line.substr(POSITION_PREFIX.size()), packed)
+            || !Compact::unpackBoard(packed, &cells[0][0], BOARDLENGTH, packedWhiteTurn)) {
+            return false;
+        }
+        // The turn line is kept for older readers; a save where it disagrees with the board is damaged
+        if (packedWhiteTurn != isWhiteTurn) {
+            return false;
+        }
+        std::copy(&cells[0][0], &cells[0][0] + BOARDLENGTH * BOARDLENGTH, &gameLogic.board[0][0]);
+    } else {
+        int y = 0;
+        do {
+            for (int x = 0; x < BOARDLENGTH && x < line.length(); x++) {
+                gameLogic.board[y][x] = line[x];
+            }
+            y++;
+        } while (y < BOARDLENGTH && std::getline(loadFile, line));
+    }
+
+    if (variations) {
+        variations->clear();
+        if (std::getline(loadFile, line) && line == "variations") {
+            while (std::getline(loadFile, line)) {
+                *variations += line + '\n';
+            }
         }
-        y++;
     }
 
     currentSaveFile = filename;
     loadFile.close();
 
     // Update available moves
+    gameLogic.boardChanged();
     gameLogic.showPlayPlace(isWhiteTurn);
 
     return true;
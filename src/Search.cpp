@@ -0,0 +1,443 @@
+//
+// Search.cpp - negamax alpha-beta with iterative deepening and multi-PV root analysis
+//
+
+#include "../headers/Search.h"
+#include "../headers/Evaluation.h"
+#include "../headers/SearchTrace.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+
+namespace {
+    // Static move priority: corners first, then A/B edge cells, X/C squares next to corners last
+    constexpr int SQUARE_PRIORITY_8[64] = {
+        9, 1, 7, 5, 5, 7, 1, 9,
+        1, 0, 3, 3, 3, 3, 0, 1,
+        7, 3, 6, 4, 4, 6, 3, 7,
+        5, 3, 4, 2, 2, 4, 3, 5,
+        5, 3, 4, 2, 2, 4, 3, 5,
+        7, 3, 6, 4, 4, 6, 3, 7,
+        1, 0, 3, 3, 3, 3, 0, 1,
+        9, 1, 7, 5, 5, 7, 1, 9
+    };
+
+    // The other sizes only tell corners, edges, X-squares and the interior apart
+    template<int N>
+    constexpr std::array<int, N * N> squarePriorities() {
+        std::array<int, N * N> priorities{};
+        for (int y = 0; y < N; y++) {
+            for (int x = 0; x < N; x++) {
+                const bool edgeX = x == 0 || x == N - 1;
+                const bool edgeY = y == 0 || y == N - 1;
+                const bool nextToCornerX = x == 1 || x == N - 2;
+                const bool nextToCornerY = y == 1 || y == N - 2;
+                priorities[y * N + x] = edgeX && edgeY ? 9 : nextToCornerX && nextToCornerY ? 0 : edgeX || edgeY ? 5 : 3;
+            }
+        }
+        return priorities;
+    }
+
+    template<int N>
+    constexpr std::array<int, N * N> SQUARE_PRIORITY = squarePriorities<N>();
+
+    template<int N>
+    int squarePriority(const int square) {
+        if constexpr (N == 8) {
+            return SQUARE_PRIORITY_8[square];
+        } else {
+            return SQUARE_PRIORITY<N>[square];
+        }
+    }
+
+    // Evaluation::FEATURE_MASKS for the other sizes
+    template<int N>
+    constexpr std::array<typename BoardGeometry<N>::Mask, Evaluation::FEATURES> FEATURE_MASKS =
+            BoardMasks::features<N>();
+
+    // Below this depth the static priority is good enough; above it moves are sorted by opponent mobility
+    constexpr int MOBILITY_ORDER_DEPTH = 3;
+}
+
+template<int N>
+GenericSearch<N>::GenericSearch(const size_t ttMegabytes) : ttMegabytes(ttMegabytes) {
+}
+
+template<int N>
+void GenericSearch<N>::clear() {
+    if (!tt.empty()) {
+        tt.clear();
+    }
+}
+
+template<int N>
+int GenericSearch<N>::finalScore(const Pos &pos) {
+    const int player = BoardBits::popcount(pos.player);
+    const int opponent = BoardBits::popcount(pos.opponent);
+    int diff = player - opponent;
+
+    if (diff > 0) {
+        diff += Geometry::CELLS - player - opponent;
+    } else if (diff < 0) {
+        diff -= Geometry::CELLS - player - opponent;
+    }
+
+    return diff * FINAL_SCALE;
+}
+
+template<int N>
+int GenericSearch<N>::orderMoves(const Pos &pos, Mask moves, const int ttMove, const int depth, int order[]) {
+    int keys[Geometry::CELLS];
+    int count = 0;
+
+    while (moves) {
+        const int square = BoardBits::lowestSquare(moves);
+        moves = BoardBits::withoutLowest(moves);
+
+        int key = squarePriority<N>(square);
+        if (depth >= MOBILITY_ORDER_DEPTH) {
+            // Fewer replies for the opponent first
+            const Mask flips = Board::getFlips(pos.player, pos.opponent, square);
+            const Pos next = Board::play(pos, square, flips);
+            key -= 4 * BoardBits::popcount(Board::getMoves(next.player, next.opponent));
+        }
+        if (square == ttMove) {
+            key = INF;
+        }
+
+        // Insertion sort, move lists are short
+        int i = count++;
+        while (i > 0 && keys[i - 1] < key) {
+            keys[i] = keys[i - 1];
+            order[i] = order[i - 1];
+            i--;
+        }
+        keys[i] = key;
+        order[i] = square;
+    }
+
+    return count;
+}
+
+template<int N>
+int GenericSearch<N>::evaluate(const Pos &pos) const {
+    if constexpr (N == 8) {
+        return network ? network->evaluate(accumulators[ply]) : Evaluation::evaluate(pos, *evaluationWeights);
+    } else {
+        // Evaluation::evaluate with the feature masks of this size
+        int score = 0;
+        for (int feature = 0; feature < Evaluation::FEATURES; feature++) {
+            if (evaluationWeights->values[feature]) {
+                const Mask mask = FEATURE_MASKS<N>[feature];
+                score += evaluationWeights->values[feature]
+                        * (BoardBits::popcount(pos.player & mask) - BoardBits::popcount(pos.opponent & mask));
+            }
+        }
+        return std::clamp(score, -Evaluation::MAX_EVAL, Evaluation::MAX_EVAL);
+    }
+}
+
+template<int N>
+int GenericSearch<N>::negamax(const Pos &pos, const int depth, int alpha, int beta) {
+    if ((++nodes & 1023) == 0 && canAbort
+        && (stopRequested.load(std::memory_order_relaxed)
+            || (nodeLimit && nodes >= nodeLimit)
+            || (timeBudget.maximum > 0.0 && std::chrono::steady_clock::now() >= deadline))) {
+        aborted = true;
+    }
+    if (aborted) {
+        return 0;
+    }
+
+    SEARCH_TRACE(NODE_ENTER, depth, 0xFF, 0xFF, 0);
+
+    const Mask moves = Board::getMoves(pos.player, pos.opponent);
+    if (!moves) {
+        // Pass does not use up depth; if neither side can move the game is over
+        int score;
+        if (Board::getMoves(pos.opponent, pos.player)) {
+            if constexpr (N == 8) {
+                if (network) {
+                    NeuralNetwork::pass(accumulators[ply], accumulators[ply + 1]);
+                }
+            }
+            ply++;
+            score = -negamax(Board::pass(pos), depth, -beta, -alpha);
+            ply--;
+        } else {
+            score = finalScore(pos);
+        }
+        SEARCH_TRACE(NODE_EXIT, depth, 0xFF, 0xFF, score);
+        return score;
+    }
+
+    if (depth <= 0) {
+        const int score = evaluate(pos);
+        SEARCH_TRACE(NODE_EXIT, depth, 0xFF, 0xFF, score);
+        return score;
+    }
+
+    // With depth for every empty square the score is exact, so solved positions can be shared
+    bool cacheable = false;
+    if constexpr (N == 8) {
+        const int empties = Board::empties(pos);
+        cacheable = endgameCache && depth >= empties && empties >= EndgameCache::MIN_EMPTIES;
+        if (cacheable) {
+            int discs;
+            if (endgameCache->probe(pos, discs)) {
+                return discs * FINAL_SCALE;
+            }
+        }
+    }
+
+    const int alphaOrig = alpha;
+    const uint64_t key = BoardBits::hash(pos.player, pos.opponent);
+    int ttMove = Geometry::PASS;
+
+    if (const TTEntry *entry = tt.probe(key)) {
+        SEARCH_TRACE(TT_HIT, depth, 0xFF, entry->bestMove, entry->score);
+        ttMove = entry->bestMove;
+
+        if (entry->depth >= depth) {
+            if (entry->bound == Bound::EXACT) {
+                return entry->score;
+            }
+            if (entry->bound == Bound::LOWER) {
+                alpha = std::max(alpha, static_cast<int>(entry->score));
+            } else if (entry->bound == Bound::UPPER) {
+                beta = std::min(beta, static_cast<int>(entry->score));
+            }
+            if (alpha >= beta) {
+                return entry->score;
+            }
+        }
+    } else {
+        SEARCH_TRACE(TT_PROBE, depth, 0xFF, 0xFF, 0);
+    }
+
+    int order[Geometry::CELLS];
+    const int count = orderMoves(pos, moves, ttMove, depth, order);
+
+    int best = -INF;
+    int bestSquare = order[0];
+
+    for (int i = 0; i < count; i++) {
+        const int square = order[i];
+        const Mask flips = Board::getFlips(pos.player, pos.opponent, square);
+        const int score = searchChild(pos, square, flips, depth - 1, alpha, beta);
+
+        if (aborted) {
+            return 0;
+        }
+
+        if (score > best) {
+            best = score;
+            bestSquare = square;
+        }
+        if (best > alpha) {
+            alpha = best;
+        }
+        if (alpha >= beta) {
+            SEARCH_TRACE(CUTOFF, depth, i, square, score);
+            break;
+        }
+    }
+
+    const Bound bound = best <= alphaOrig ? Bound::UPPER : best >= beta ? Bound::LOWER : Bound::EXACT;
+    tt.store(key, best, depth, bound, bestSquare);
+    if constexpr (N == 8) {
+        if (cacheable && bound == Bound::EXACT) {
+            endgameCache->store(pos, discDifference(best), bestSquare);
+        }
+    }
+
+    SEARCH_TRACE(NODE_EXIT, depth, 0xFF, 0xFF, best);
+    return best;
+}
+
+template<int N>
+int GenericSearch<N>::searchChild(const Pos &pos, const int square, const Mask flips, const int depth,
+                                  const int alpha, const int beta) {
+    if constexpr (N == 8) {
+        if (network) {
+            network->update(accumulators[ply], accumulators[ply + 1], square, flips);
+        }
+    }
+
+    ply++;
+    const int score = -negamax(Board::play(pos, square, flips), depth, -beta, -alpha);
+    ply--;
+    return score;
+}
+
+template<int N>
+void GenericSearch<N>::prepareRoot(const Pos &pos) {
+    if (tt.empty()) {
+        tt.resize(ttMegabytes);
+    }
+
+    aborted = false;
+    canAbort = false;
+    ply = 0;
+    if constexpr (N == 8) {
+        if (network) {
+            network->refresh(pos, accumulators[0]);
+        }
+    }
+}
+
+template<int N>
+std::vector<MoveScore> GenericSearch<N>::analyze(const Pos &pos, const int maxDepth, const int multiPV,
+                                                 const std::function<void(const AnalysisInfo &)> &onDepth) {
+    const auto startTime = std::chrono::steady_clock::now();
+    deadline = startTime + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                   std::chrono::duration<double>(timeBudget.maximum));
+    nodes = 0;
+    prepareRoot(pos);
+
+    const Mask rootMoves = Board::getMoves(pos.player, pos.opponent);
+    if (!rootMoves) {
+        return {};
+    }
+
+    // Root moves in the order they are searched, rescored every iteration
+    int order[Geometry::CELLS];
+    const int count = orderMoves(pos, rootMoves, Geometry::PASS, 0, order);
+
+    // Scratch lists come from the arena so iterations do not touch the heap
+    arena.reset();
+    MoveScore *current = arena.allocateArray<MoveScore>(count);
+    MoveScore *next = arena.allocateArray<MoveScore>(count);
+    int *exactScores = arena.allocateArray<int>(count);
+    for (int i = 0; i < count; i++) {
+        current[i] = {order[i], -INF, false};
+    }
+
+    const int wanted = multiPV <= 0 ? count : std::min(multiPV, count);
+    const int empties = Board::empties(pos);
+    std::vector<MoveScore> result;
+
+    for (int depth = 1; depth <= std::max(1, maxDepth); depth++) {
+        // Exact scores found so far in this iteration, best first
+        int exactCount = 0;
+        int scored = 0;
+
+        for (int i = 0; i < count; i++) {
+            const MoveScore &move = current[i];
+
+            // Once the top K are known a move only needs to prove it beats the K-th best
+            const int alpha = exactCount >= wanted ? exactScores[wanted - 1] : -INF;
+
+            const Mask flips = Board::getFlips(pos.player, pos.opponent, move.square);
+            const int score = searchChild(pos, move.square, flips, depth - 1, alpha, INF);
+            if (aborted) {
+                break;
+            }
+
+            const bool exact = score > alpha;
+            next[scored++] = {move.square, score, exact};
+            if (exact) {
+                int *slot = std::upper_bound(exactScores, exactScores + exactCount, score, std::greater<int>());
+                std::copy_backward(slot, exactScores + exactCount, exactScores + exactCount + 1);
+                *slot = score;
+                exactCount++;
+            }
+        }
+
+        if (aborted) {
+            break;
+        }
+
+        std::stable_sort(next, next + count, [](const MoveScore &a, const MoveScore &b) {
+            if (a.exact != b.exact) {
+                return a.exact;
+            }
+            return a.score > b.score;
+        });
+
+        std::copy(next, next + count, current);
+        result.assign(next, next + wanted);
+
+        if (onDepth) {
+            AnalysisInfo info;
+            info.depth = depth;
+            info.moves = result;
+            info.nodes = nodes;
+            info.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+            onDepth(info);
+        }
+
+        // The first iteration always completes so there is a move to return
+        canAbort = true;
+
+        // Deeper iterations cannot change anything once every line reaches the end of the game
+        if (depth >= empties || stopRequested.load(std::memory_order_relaxed)) {
+            break;
+        }
+
+        // The next iteration costs several times this one, so start it only early in the budget
+        const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+        if (timeBudget.target > 0.0 && elapsed >= timeBudget.target / 2) {
+            break;
+        }
+        if (nodeLimit && nodes >= nodeLimit / 2) {
+            break;
+        }
+    }
+
+    return result;
+}
+
+template<int N>
+int GenericSearch<N>::bestMove(const Pos &pos, const int depth) {
+    const std::vector<MoveScore> moves = analyze(pos, depth, 1);
+    return moves.empty() ? Geometry::PASS : moves.front().square;
+}
+
+template<int N>
+int GenericSearch<N>::scoreMove(const Pos &pos, const int square, const int depth) {
+    nodes = 0;
+    prepareRoot(pos);
+
+    const Mask flips = Board::getFlips(pos.player, pos.opponent, square);
+    return searchChild(pos, square, flips, depth - 1, -INF, INF);
+}
+
+template<int N>
+MoveScore GenericSearch<N>::solve(const Pos &pos) {
+    if (!Board::getMoves(pos.player, pos.opponent)) {
+        if (!Board::getMoves(pos.opponent, pos.player)) {
+            return {Geometry::PASS, discDifference(finalScore(pos)), true};
+        }
+        const MoveScore reply = solve(Board::pass(pos));
+        return {Geometry::PASS, -reply.score, reply.exact};
+    }
+
+    if constexpr (N == 8) {
+        int score;
+        int square;
+        if (endgameCache && endgameCache->probe(pos, score, &square)) {
+            return {square, score, true};
+        }
+    }
+
+    const int empties = Board::empties(pos);
+    int solvedDepth = 0;
+    const std::vector<MoveScore> moves = analyze(pos, empties, 1, [&](const AnalysisInfo &info) {
+        solvedDepth = info.depth;
+    });
+
+    const MoveScore &best = moves.front();
+    const bool exact = solvedDepth >= empties;
+    if constexpr (N == 8) {
+        if (exact && endgameCache) {
+            endgameCache->store(pos, discDifference(best.score), best.square);
+        }
+    }
+    return {best.square, isFinalScore(best.score) ? discDifference(best.score) : best.score, exact};
+}
+
+template class GenericSearch<6>;
+template class GenericSearch<8>;
+template class GenericSearch<10>;
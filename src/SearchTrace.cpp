@@ -0,0 +1,234 @@
+//
+// SearchTrace.cpp - per-thread event rings drained to the trace file by a writer thread
+//
+
+#include "../headers/SearchTrace.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+    /**
+     * Single-producer single-consumer ring. The recording thread only moves
+     * head and the writer thread only moves tail, so neither side locks.
+     */
+    struct EventRing {
+        std::vector<TraceEvent> events;
+        std::atomic<uint64_t> head{0};
+        std::atomic<uint64_t> tail{0};
+        std::atomic<bool> closed{false};
+        uint16_t threadId;
+
+        explicit EventRing(const uint16_t threadId) : events(SearchTrace::BUFFER_EVENTS), threadId(threadId) {}
+    };
+
+    // Wait between two passes of the writer when nobody asked for a drain
+    constexpr auto WRITER_INTERVAL = std::chrono::milliseconds(10);
+
+    // Owns the trace file and the thread that empties every ring into it
+    class TraceWriter {
+    public:
+        TraceWriter() : writer(&TraceWriter::run, this) {}
+
+        ~TraceWriter() {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                stopping = true;
+            }
+            wake.notify_one();
+            writer.join();
+            if (file) {
+                fclose(file);
+            }
+        }
+
+        void setPath(const std::string &value) {
+            std::lock_guard<std::mutex> lock(mutex);
+            path = value;
+        }
+
+        void add(const std::shared_ptr<EventRing> &ring) {
+            std::lock_guard<std::mutex> lock(mutex);
+            rings.push_back(ring);
+        }
+
+        // Ask for an early pass, e.g. when half a ring has filled up
+        void nudge() {
+            // A lost wakeup only delays the pass until the next interval
+            nudged.store(true, std::memory_order_relaxed);
+            wake.notify_one();
+        }
+
+        // Block until everything recorded so far by ring is on disk
+        void drain(const EventRing &ring) {
+            const uint64_t target = ring.head.load(std::memory_order_relaxed);
+            std::unique_lock<std::mutex> lock(mutex);
+            ++drainRequests;
+            wake.notify_one();
+            drained.wait(lock, [&]() { return ring.tail.load(std::memory_order_acquire) >= target; });
+            --drainRequests;
+        }
+
+    private:
+        std::mutex mutex;
+        std::condition_variable wake;
+        std::condition_variable drained;
+        std::vector<std::shared_ptr<EventRing>> rings;
+        std::string path;
+        std::atomic<bool> nudged{false};
+        int drainRequests = 0;
+        bool stopping = false;
+        bool failed = false;
+        FILE *file = nullptr;   // only used by the writer thread
+        std::thread writer;
+
+        void run() {
+            std::unique_lock<std::mutex> lock(mutex);
+            while (true) {
+                wake.wait_for(lock, WRITER_INTERVAL, [&]() {
+                    return stopping || drainRequests > 0 || nudged.load(std::memory_order_relaxed);
+                });
+                nudged.store(false, std::memory_order_relaxed);
+                const bool flushing = stopping || drainRequests > 0;
+                const std::vector<std::shared_ptr<EventRing>> pending = rings;
+                lock.unlock();
+
+                for (const std::shared_ptr<EventRing> &ring: pending) {
+                    writeRing(*ring);
+                }
+                if (flushing && file) {
+                    fflush(file);
+                }
+
+                lock.lock();
+                // A closed ring gets no more events once it has been written out
+                rings.erase(std::remove_if(rings.begin(), rings.end(), [](const std::shared_ptr<EventRing> &ring) {
+                    return ring->closed.load(std::memory_order_acquire) &&
+                           ring->tail.load(std::memory_order_relaxed) == ring->head.load(std::memory_order_acquire);
+                }), rings.end());
+                drained.notify_all();
+                // The final pass above already wrote out everything recorded so far
+                if (stopping) {
+                    return;
+                }
+            }
+        }
+
+        void writeRing(EventRing &ring) {
+            const uint64_t head = ring.head.load(std::memory_order_acquire);
+            uint64_t tail = ring.tail.load(std::memory_order_relaxed);
+            while (tail != head) {
+                const size_t start = static_cast<size_t>(tail % ring.events.size());
+                const size_t count = static_cast<size_t>(std::min<uint64_t>(head - tail, ring.events.size() - start));
+                if (open()) {
+                    fwrite(ring.events.data() + start, sizeof(TraceEvent), count, file);
+                }
+                tail += count;
+                // Without a file the events are still consumed so recording never stalls
+                ring.tail.store(tail, std::memory_order_release);
+            }
+        }
+
+        bool open() {
+            if (file) {
+                return true;
+            }
+            std::string target;
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (failed) {
+                    return false;
+                }
+                if (path.empty()) {
+                    const char *env = std::getenv("REVERSI_TRACE_FILE");
+                    path = env ? env : "search_trace.bin";
+                }
+                target = path;
+            }
+            file = fopen(target.c_str(), "wb");
+            if (!file) {
+                std::lock_guard<std::mutex> lock(mutex);
+                failed = true;
+                return false;
+            }
+            const uint32_t header[2] = {TRACE_VERSION, sizeof(TraceEvent)};
+            fwrite(TRACE_MAGIC, 1, sizeof(TRACE_MAGIC), file);
+            fwrite(header, sizeof(uint32_t), 2, file);
+            return true;
+        }
+    };
+
+    TraceWriter &traceWriter() {
+        static TraceWriter instance;
+        return instance;
+    }
+
+    std::atomic<uint16_t> nextThreadId{0};
+
+    // The recording side of one thread's ring
+    struct ThreadBuffer {
+        std::shared_ptr<EventRing> ring;
+
+        ThreadBuffer() : ring(std::make_shared<EventRing>(nextThreadId++)) {
+            // Created first so the writer outlives every thread's buffer
+            traceWriter().add(ring);
+        }
+
+        ~ThreadBuffer() {
+            ring->closed.store(true, std::memory_order_release);
+            traceWriter().nudge();
+        }
+    };
+
+    ThreadBuffer &threadBuffer() {
+        thread_local ThreadBuffer buffer;
+        return buffer;
+    }
+
+    uint8_t clampByte(const int value) {
+        return static_cast<uint8_t>(value < 0 || value > 0xFF ? 0xFF : value);
+    }
+}
+
+void SearchTrace::setOutputFile(const std::string &path) {
+    traceWriter().setPath(path);
+}
+
+void SearchTrace::record(const TraceEventType type, const int depth, const int moveIndex, const int square,
+                         const int score) {
+    EventRing &ring = *threadBuffer().ring;
+    const uint64_t head = ring.head.load(std::memory_order_relaxed);
+    if (head - ring.tail.load(std::memory_order_acquire) == ring.events.size()) {
+        // The disk fell a whole ring behind; wait rather than lose events
+        traceWriter().nudge();
+        while (head - ring.tail.load(std::memory_order_acquire) == ring.events.size()) {
+            std::this_thread::yield();
+        }
+    }
+
+    TraceEvent &event = ring.events[static_cast<size_t>(head % ring.events.size())];
+    event.type = static_cast<uint8_t>(type);
+    event.depth = clampByte(depth);
+    event.moveIndex = clampByte(moveIndex);
+    event.square = clampByte(square);
+    event.thread = ring.threadId;
+    event.score = static_cast<int16_t>(std::clamp(score, -32768, 32767));
+    ring.head.store(head + 1, std::memory_order_release);
+
+    // Hand each filled half to the writer straight away, like a double buffer
+    if ((head + 1) % (ring.events.size() / 2) == 0) {
+        traceWriter().nudge();
+    }
+}
+
+void SearchTrace::flush() {
+    traceWriter().drain(*threadBuffer().ring);
+}
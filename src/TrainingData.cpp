@@ -0,0 +1,71 @@
+//
+// TrainingData.cpp - training record file output and loading
+//
+
+#include "../headers/TrainingData.h"
+
+#include <cstring>
+
+TrainingDataWriter::~TrainingDataWriter() {
+    close();
+}
+
+bool TrainingDataWriter::open(const std::string &path) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (file) {
+        fclose(file);
+    }
+
+    file = fopen(path.c_str(), "wb");
+    if (!file) {
+        return false;
+    }
+
+    const uint32_t header[2] = {TRAINING_VERSION, sizeof(TrainingRecord)};
+    fwrite(TRAINING_MAGIC, 1, sizeof(TRAINING_MAGIC), file);
+    fwrite(header, sizeof(uint32_t), 2, file);
+    recordsWritten = 0;
+    return true;
+}
+
+void TrainingDataWriter::write(const std::vector<TrainingRecord> &records) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (file && !records.empty()) {
+        fwrite(records.data(), sizeof(TrainingRecord), records.size(), file);
+        recordsWritten += records.size();
+    }
+}
+
+void TrainingDataWriter::close() {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (file) {
+        fclose(file);
+        file = nullptr;
+    }
+}
+
+bool TrainingData::read(const std::string &path, std::vector<TrainingRecord> &records) {
+    FILE *file = fopen(path.c_str(), "rb");
+    if (!file) {
+        return false;
+    }
+
+    char magic[8];
+    uint32_t header[2];
+    if (fread(magic, 1, sizeof(magic), file) != sizeof(magic) || fread(header, sizeof(uint32_t), 2, file) != 2
+        || std::memcmp(magic, TRAINING_MAGIC, sizeof(magic)) != 0 || header[0] != TRAINING_VERSION
+        || header[1] != sizeof(TrainingRecord)) {
+        fclose(file);
+        return false;
+    }
+
+    records.clear();
+    TrainingRecord chunk[4096];
+    size_t count;
+    while ((count = fread(chunk, sizeof(TrainingRecord), 4096, file)) > 0) {
+        records.insert(records.end(), chunk, chunk + count);
+    }
+
+    fclose(file);
+    return true;
+}
@@ -0,0 +1,90 @@
+//
+// Transcript.cpp - parsing and formatting of move transcripts
+//
+
+#include "../headers/Transcript.h"
+
+#include <cctype>
+
+bool Transcript::parse(const std::string &text, GameLine &game, std::string &error) {
+    game = GameLine();
+
+    std::vector<int> moves;
+    size_t i = 0;
+    while (i < text.size()) {
+        if (std::isspace(static_cast<unsigned char>(text[i]))) {
+            i++;
+            continue;
+        }
+        if (i + 1 >= text.size()) {
+            error = "trailing character at " + std::to_string(i);
+            return false;
+        }
+
+        const std::string token = text.substr(i, 2);
+        i += 2;
+
+        if (token == "pa" || token == "PA" || token == "--") {
+            moves.push_back(Bitboard::PASS);
+            continue;
+        }
+
+        const int square = Bitboard::parseSquare(token);
+        if (square < 0) {
+            error = "unreadable move '" + token + "'";
+            return false;
+        }
+        moves.push_back(square);
+    }
+
+    return replay(moves, game, error);
+}
+
+bool Transcript::replay(const std::vector<int> &moves, GameLine &game, std::string &error) {
+    game = GameLine();
+
+    Position pos = Bitboard::initial();
+    bool whiteToMove = false;
+
+    for (const int square: moves) {
+        // The mover has no legal move: the record may or may not spell out the pass
+        if (!Bitboard::getMoves(pos.player, pos.opponent)) {
+            pos = Bitboard::pass(pos);
+            whiteToMove = !whiteToMove;
+            if (square == Bitboard::PASS) {
+                continue;
+            }
+        }
+
+        const uint64_t flips = square == Bitboard::PASS ? 0 : Bitboard::getFlips(pos.player, pos.opponent, square);
+        if (!flips || ((pos.player | pos.opponent) & Bitboard::squareBit(square))) {
+            error = "illegal move " + Bitboard::squareName(square) + " at move "
+                    + std::to_string(game.moves.size() + 1);
+            return false;
+        }
+
+        game.moves.push_back(square);
+        game.positions.push_back(pos);
+        game.whiteToMove.push_back(whiteToMove);
+
+        pos = Bitboard::play(pos, square, flips);
+        whiteToMove = !whiteToMove;
+    }
+
+    if (!Bitboard::getMoves(pos.player, pos.opponent) && Bitboard::getMoves(pos.opponent, pos.player)) {
+        pos = Bitboard::pass(pos);
+        whiteToMove = !whiteToMove;
+    }
+
+    game.finalPosition = pos;
+    game.finalWhiteToMove = whiteToMove;
+    return true;
+}
+
+std::string Transcript::format(const std::vector<int> &moves) {
+    std::string text;
+    for (const int square: moves) {
+        text += Bitboard::squareName(square);
+    }
+    return text;
+}
@@ -0,0 +1,21 @@
+//
+// TranspositionTable.cpp
+//
+
+#include "../headers/TranspositionTable.h"
+
+#include <algorithm>
+
+void TranspositionTable::resize(const size_t megabytes) {
+    size_t count = 1;
+    while (count * 2 * sizeof(TTEntry) <= megabytes * 1024 * 1024) {
+        count *= 2;
+    }
+
+    entries.assign(count, TTEntry{});
+    mask = count - 1;
+}
+
+void TranspositionTable::clear() {
+    std::fill(entries.begin(), entries.end(), TTEntry{});
+}
@@ -0,0 +1,426 @@
+//
+// ReversiAnalyze.cpp - headless batch analyzer for saved games and transcripts
+//
+// Usage: reversi_analyze [options] [save files or directories...]
+//   -t FILE      transcript file, one game per line ("f5d6c3d3...")
+//   -d DEPTH     search depth in plies (default 8)
+//   -j THREADS   worker threads (default: all cores)
+//   -b LOSS      loss at or above which a move is a blunder (default 10)
+//   -m MB        transposition table per worker (default 32)
+//   -e FILE      endgame cache shared by all workers and runs, created when missing
+// With no inputs every save in saves/ is analysed. Saves that keep their move tree are annotated
+// along the moves that led to the saved position, like transcripts.
+//
+
+#include "../headers/Bitboard.h"
+#include "../headers/Compact.h"
+#include "../headers/EndgameCache.h"
+#include "../headers/FundamentalFunction.h"
+#include "../headers/MoveTree.h"
+#include "../headers/SaveGame.h"
+#include "../headers/Search.h"
+#include "../headers/Transcript.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+    struct Options {
+        int depth = 8;
+        int threads = 0;
+        int blunderLoss = 10;
+        size_t ttMegabytes = 32;
+    };
+
+    struct Job {
+        bool isTranscript = false;
+        std::string source;     // file name, plus line number for transcripts
+        std::string text;       // transcript moves
+    };
+
+    struct JobResult {
+        std::string report;
+        int positions = 0;
+        int blunders = 0;
+        uint64_t nodes = 0;
+    };
+
+    std::string formatScore(const int score) {
+        if (Search::isFinalScore(score)) {
+            const int discs = Search::discDifference(score);
+            return (discs > 0 ? "=+" : "=") + std::to_string(discs);
+        }
+        return (score > 0 ? "+" : "") + std::to_string(score);
+    }
+
+    std::string formatLoss(const int best, const int played) {
+        if (Search::isFinalScore(best) && Search::isFinalScore(played)) {
+            return std::to_string(Search::discDifference(best) - Search::discDifference(played)) + " discs";
+        }
+        return std::to_string(best - played);
+    }
+
+    const char *colorName(const bool isWhite) {
+        return isWhite ? "white" : "black";
+    }
+
+    // Position of a move tree node, seen from the side to move
+    struct LineState {
+        Position pos{};
+        bool whiteToMove = false;
+    };
+
+    // MoveTree::read callback with the turn rules of the game screen: pass back when the next player cannot move
+    bool playLine(const LineState &from, const int x, const int y, const bool byWhite, LineState &to) {
+        if (x < 0 || x >= Bitboard::SIZE || y < 0 || y >= Bitboard::SIZE || from.whiteToMove != byWhite) {
+            return false;
+        }
+        const int square = y * Bitboard::SIZE + x;
+        const uint64_t flips = Bitboard::getFlips(from.pos.player, from.pos.opponent, square);
+        if (!flips || ((from.pos.player | from.pos.opponent) & Bitboard::squareBit(square))) {
+            return false;
+        }
+
+        to.pos = Bitboard::play(from.pos, square, flips);
+        to.whiteToMove = !byWhite;
+        if (!Bitboard::getMoves(to.pos.player, to.pos.opponent)) {
+            to.pos = Bitboard::pass(to.pos);
+            to.whiteToMove = byWhite;
+        }
+        return true;
+    }
+
+    /**
+     * Rebuild the line leading to the saved position from the variations of a
+     * save: the start position, packed or as raw cells and turn in older saves,
+     * then the move tree.
+     * @return false when the save has no readable variations
+     */
+    bool readSavedLine(const std::string &variations, GameLine &game) {
+        std::istringstream in(variations);
+        std::string rootBoard;
+        if (!(in >> rootBoard)) {
+            return false;
+        }
+
+        char cells[Bitboard::SIZE][Bitboard::SIZE];
+        bool rootWhiteTurn = false;
+        if (rootBoard.size() == sizeof(cells)) {
+            std::copy(rootBoard.begin(), rootBoard.end(), &cells[0][0]);
+            if (!(in >> rootWhiteTurn)) {
+                return false;
+            }
+        } else {
+            std::string packedRoot;
+            if (!Compact::fromText(rootBoard, packedRoot)
+                || !Compact::unpackBoard(packedRoot, &cells[0][0], Bitboard::SIZE, rootWhiteTurn)) {
+                return false;
+            }
+        }
+
+        LineState root;
+        root.pos = Bitboard::fromBoard(cells, rootWhiteTurn);
+        root.whiteToMove = rootWhiteTurn;
+        if (!Bitboard::getMoves(root.pos.player, root.pos.opponent)) {
+            root.pos = Bitboard::pass(root.pos);
+            root.whiteToMove = !rootWhiteTurn;
+        }
+
+        MoveTree<LineState> tree;
+        if (!tree.read(in, root, playLine)) {
+            return false;
+        }
+
+        // Only the moves on the way to the saved node were played; other variations are not annotated
+        std::vector<int> line;
+        for (int index = tree.getCurrent(); tree[index].parent != MoveTree<LineState>::NONE;
+             index = tree[index].parent) {
+            line.push_back(index);
+        }
+        std::reverse(line.begin(), line.end());
+
+        game = GameLine();
+        for (const int index: line) {
+            const MoveTree<LineState>::Node &node = tree[index];
+            game.moves.push_back(node.y * Bitboard::SIZE + node.x);
+            game.positions.push_back(tree[node.parent].state.pos);
+            game.whiteToMove.push_back(node.byWhite);
+        }
+        game.finalPosition = tree.getCurrentNode().state.pos;
+        game.finalWhiteToMove = tree.getCurrentNode().state.whiteToMove;
+        return true;
+    }
+
+    // Score every move of `game` against the best one, then the disc count and per-side averages
+    void annotateLine(const GameLine &game, Search &search, const Options &options, std::ostream &out,
+                      JobResult &result) {
+        long long totalLoss[2] = {0, 0};
+        int moveCount[2] = {0, 0};
+        int blunders[2] = {0, 0};
+
+        for (size_t i = 0; i < game.moves.size(); i++) {
+            const Position &pos = game.positions[i];
+            const int played = game.moves[i];
+            const int side = game.whiteToMove[i] ? 1 : 0;
+
+            const std::vector<MoveScore> best = search.analyze(pos, options.depth, 1);
+            result.nodes += search.getNodes();
+            int playedScore = best.front().score;
+            if (played != best.front().square) {
+                playedScore = search.scoreMove(pos, played, options.depth);
+                result.nodes += search.getNodes();
+            }
+
+            const int loss = best.front().score - playedScore;
+            const bool blunder = loss >= options.blunderLoss;
+
+            // Disc-margin losses are huge in eval units, count them as one blunder but not in the average
+            if (!Search::isFinalScore(loss)) {
+                totalLoss[side] += loss;
+            }
+            moveCount[side]++;
+            blunders[side] += blunder;
+
+            out << "   " << (i + 1) << ". " << Bitboard::squareName(played) << " (" << colorName(side)
+                << ") " << formatScore(playedScore);
+            if (loss > 0) {
+                out << "  best " << Bitboard::squareName(best.front().square) << ' '
+                    << formatScore(best.front().score) << "  loss " << formatLoss(best.front().score, playedScore);
+            }
+            out << (blunder ? "  ??" : "") << '\n';
+        }
+
+        const Position &last = game.finalPosition;
+        const int lastPlayer = Bitboard::popcount(last.player);
+        const int lastOpponent = Bitboard::popcount(last.opponent);
+        const int black = game.finalWhiteToMove ? lastOpponent : lastPlayer;
+        const int white = game.finalWhiteToMove ? lastPlayer : lastOpponent;
+
+        out << "   summary: black " << black << " - white " << white;
+        for (int side = 0; side < 2; side++) {
+            out << " | " << colorName(side) << " avg loss "
+                << (moveCount[side] ? static_cast<double>(totalLoss[side]) / moveCount[side] : 0.0)
+                << ", blunders " << blunders[side];
+        }
+        out << '\n';
+
+        result.positions += static_cast<int>(game.moves.size());
+        result.blunders += blunders[0] + blunders[1];
+    }
+
+    JobResult analyzeSave(const Job &job, Search &search, const Options &options) {
+        JobResult result;
+        std::ostringstream out;
+
+        SaveGame saveGame;
+        FundamentalFunction gameLogic;
+        std::string player1Name, player2Name, variations;
+        bool isWhiteTurn = false, vsComputer = false;
+        int player1Chances = 0, player2Chances = 0;
+
+        bool loaded;
+        try {
+            loaded = saveGame.loadGame(job.source, gameLogic, player1Name, player2Name, isWhiteTurn, vsComputer,
+                                       player1Chances, player2Chances, &variations);
+        } catch (const std::exception &) {
+            loaded = false;
+        }
+        if (!loaded) {
+            out << "== " << job.source << ": unreadable save\n";
+            result.report = out.str();
+            return result;
+        }
+
+        Position pos = Bitboard::fromBoard(gameLogic.board, isWhiteTurn);
+        out << "== " << job.source << " (" << player1Name << " vs " << player2Name << ", "
+            << colorName(isWhiteTurn) << " to move)\n";
+
+        // The moves that led here, when the save kept them
+        GameLine game;
+        if (readSavedLine(variations, game)) {
+            annotateLine(game, search, options, out, result);
+        } else {
+            out << "   no move record, only the saved position is scored\n";
+        }
+
+        if (!Bitboard::getMoves(pos.player, pos.opponent)) {
+            if (!Bitboard::getMoves(pos.opponent, pos.player)) {
+                out << "   game over, final " << formatScore(Search::finalScore(pos)) << " for "
+                    << colorName(isWhiteTurn) << '\n';
+                result.report = out.str();
+                return result;
+            }
+            out << "   " << colorName(isWhiteTurn) << " must pass\n";
+            pos = Bitboard::pass(pos);
+            isWhiteTurn = !isWhiteTurn;
+        }
+
+        // Candidates for the next move; none of them has been played, so none is judged
+        const std::vector<MoveScore> moves = search.analyze(pos, options.depth);
+        result.positions++;
+        result.nodes += search.getNodes();
+
+        out << "   best " << Bitboard::squareName(moves.front().square) << ' '
+            << formatScore(moves.front().score) << " for " << colorName(isWhiteTurn) << '\n';
+        for (const MoveScore &move: moves) {
+            out << "   " << Bitboard::squareName(move.square) << ' ' << formatScore(move.score) << '\n';
+        }
+
+        result.report = out.str();
+        return result;
+    }
+
+    JobResult analyzeTranscript(const Job &job, Search &search, const Options &options) {
+        JobResult result;
+        std::ostringstream out;
+
+        GameLine game;
+        std::string error;
+        if (!Transcript::parse(job.text, game, error)) {
+            out << "== " << job.source << ": " << error << '\n';
+            result.report = out.str();
+            return result;
+        }
+
+        out << "== " << job.source << " (" << game.moves.size() << " moves)\n";
+        annotateLine(game, search, options, out, result);
+
+        result.report = out.str();
+        return result;
+    }
+
+    void addSaves(const std::string &path, std::vector<Job> &jobs) {
+        namespace fs = std::filesystem;
+
+        if (fs::is_directory(path)) {
+            std::vector<std::string> files;
+            for (const auto &entry: fs::directory_iterator(path)) {
+                if (entry.is_regular_file() && entry.path().extension() == ".txt") {
+                    files.push_back(entry.path().string());
+                }
+            }
+            std::sort(files.begin(), files.end());
+            for (const std::string &file: files) {
+                jobs.push_back({false, file, ""});
+            }
+        } else {
+            jobs.push_back({false, path, ""});
+        }
+    }
+
+    bool addTranscripts(const std::string &path, std::vector<Job> &jobs) {
+        std::ifstream file(path);
+        if (!file.is_open()) {
+            return false;
+        }
+
+        std::string line;
+        int lineNumber = 0;
+        while (std::getline(file, line)) {
+            lineNumber++;
+            if (line.find_first_not_of(" \t\r") == std::string::npos || line[0] == '#') {
+                continue;
+            }
+            jobs.push_back({true, path + ":" + std::to_string(lineNumber), line});
+        }
+        return true;
+    }
+}
+
+int main(int argc, char *argv[]) {
+    Options options;
+    EndgameCache endgameCache;
+    std::vector<Job> jobs;
+    bool anyInput = false;
+
+    for (int i = 1; i < argc; i++) {
+        const std::string arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+
+        if (arg == "-t" && hasValue) {
+            anyInput = true;
+            if (!addTranscripts(argv[++i], jobs)) {
+                std::cerr << "Can't open transcript file: " << argv[i] << std::endl;
+                return 1;
+            }
+        } else if (arg == "-d" && hasValue) {
+            options.depth = std::stoi(argv[++i]);
+        } else if (arg == "-j" && hasValue) {
+            options.threads = std::stoi(argv[++i]);
+        } else if (arg == "-b" && hasValue) {
+            options.blunderLoss = std::stoi(argv[++i]);
+        } else if (arg == "-m" && hasValue) {
+            options.ttMegabytes = std::stoul(argv[++i]);
+        } else if (arg == "-e" && hasValue) {
+            if (!endgameCache.open(argv[++i])) {
+                std::cerr << "Can't open endgame cache: " << argv[i] << std::endl;
+                return 1;
+            }
+        } else if (!arg.empty() && arg[0] == '-') {
+            std::cerr << "Usage: reversi_analyze [-t transcripts] [-d depth] [-j threads] [-b loss] [-m MB] "
+                         "[-e cache] [saves...]" << std::endl;
+            return 1;
+        } else {
+            anyInput = true;
+            addSaves(arg, jobs);
+        }
+    }
+
+    if (!anyInput && std::filesystem::is_directory("saves")) {
+        addSaves("saves", jobs);
+    }
+    if (jobs.empty()) {
+        std::cerr << "Nothing to analyse" << std::endl;
+        return 1;
+    }
+
+    int threads = options.threads > 0 ? options.threads : static_cast<int>(std::thread::hardware_concurrency());
+    threads = std::max(1, std::min(threads, static_cast<int>(jobs.size())));
+
+    // One game per worker at a time; every worker keeps its own table across its games
+    std::vector<JobResult> results(jobs.size());
+    std::atomic<size_t> nextJob{0};
+    const auto startTime = std::chrono::steady_clock::now();
+
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; t++) {
+        workers.emplace_back([&]() {
+            Search search(options.ttMegabytes);
+            if (endgameCache.isOpen()) {
+                search.setEndgameCache(&endgameCache);
+            }
+            for (size_t index = nextJob++; index < jobs.size(); index = nextJob++) {
+                const Job &job = jobs[index];
+                results[index] = job.isTranscript ? analyzeTranscript(job, search, options)
+                                                  : analyzeSave(job, search, options);
+            }
+        });
+    }
+    for (std::thread &worker: workers) {
+        worker.join();
+    }
+
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+
+    long long positions = 0, blunders = 0;
+    uint64_t nodes = 0;
+    for (const JobResult &result: results) {
+        std::cout << result.report;
+        positions += result.positions;
+        blunders += result.blunders;
+        nodes += result.nodes;
+    }
+
+    std::cout << "\n" << jobs.size() << " games, " << positions << " positions, " << blunders << " blunders in "
+              << seconds << " s (" << threads << " threads, " << static_cast<uint64_t>(nodes / std::max(seconds, 1e-9))
+              << " nodes/s)" << std::endl;
+    return 0;
+}
@@ -0,0 +1,319 @@
+//
+// ReversiBench.cpp - fixed endgame and midgame suite for timing the search
+//
+// Usage: reversi_bench [options]
+//   -t SUITE     endgame, midgame or all (default all)
+//   -f FILE      solve the positions of FILE instead of the built-in suite
+//   -m MB        transposition table (default 64)
+//   -o FILE      JSON result file (default reversi_bench.json)
+//   -l LABEL     free text stored in the JSON result, e.g. the commit
+// Endgame positions are solved exactly and must reach their known disc
+// difference. Midgame positions are searched to a fixed depth and must
+// reproduce the recorded best move and score; a change there means the
+// search or the evaluation behaves differently. Every position starts from
+// an empty table and the built-in evaluation weights, so node counts are
+// reproducible and can be compared between builds. The exit status is 1
+// when any position is wrong.
+//
+// Suite files hold one position per line in the usual test-suite layout:
+//   <64 chars: X black, O white, - empty> <X|O to move>[;] [move:score ...]
+// The first "move:score" gives the expected disc difference for the side to
+// move; lines without one are timed but not checked.
+//
+
+#include "../headers/Bitboard.h"
+#include "../headers/Evaluation.h"
+#include "../headers/Search.h"
+
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+    struct Options {
+        bool endgame = true;
+        bool midgame = true;
+        std::string suiteFile;
+        size_t ttMegabytes = 64;
+        std::string output = "reversi_bench.json";
+        std::string label;
+    };
+
+    struct BenchPosition {
+        std::string name;
+        std::string board;
+        char side;
+        int depth;              // 0: solve to the end
+        std::string move;       // expected best move, empty when any best move will do
+        int score;              // expected score for the side to move: discs when solved, else evaluation
+        bool checked;
+    };
+
+    struct BenchResult {
+        const BenchPosition *position;
+        int empties = 0;
+        std::string move;
+        int score = 0;
+        bool correct = false;
+        uint64_t nodes = 0;
+        double seconds = 0.0;
+    };
+
+    // Depth of the midgame positions; their expected moves and scores were recorded at this depth
+    constexpr int MIDGAME_DEPTH = 12;
+
+    // FFO #40 and positions from self-play games, solved once to get their value
+    const BenchPosition ENDGAME_SUITE[] = {
+        {"ffo40", "O--OOOOX-OOOOOOXOOXXOOOXOOXOOOXXOOOOOOXX---OOOOX----O--X--------", 'X', 0, "", 38, true},
+        {"end-a", "OOXXXXXX-OXXXO--O-XXXXXX-OXOXOXOXOXOOX---OOOXX--O-OXXX----XXXX--", 'O', 0, "", -32, true},
+        {"end-b", "XXXX-----XXX----XOXXOX-XXOXOXO-XXOOOOXOX--OOOOO--O-OOOOOO--OOOXO", 'X', 0, "", 22, true},
+        {"end-c", "---XXXX-O-XXXO-XO-OXOXO-OOXXOOXOOXXOOOX-OOXXOXXXO--OXXX---OOOOO-", 'O', 0, "", 34, true},
+        {"end-d", "X------OXX--O-O-XXXOOOOOOOOOOOO-OOOXXO--OXXXOO--OXXXOOO-XXXXOOOO", 'X', 0, "", 16, true},
+        {"end-e", "-X-O-X----XOXX--OXXXXX-OO-XOOOOOOOXXOXOO-XOOOXOOXXXOOX---OOOO-X-", 'O', 0, "", 34, true},
+        {"end-f", "-O-X-O-X--OXXOO-OOOOOX-O-OXXOXX--OOXXXXXO-XOXX---XXXOXX-XXXXXX--", 'X', 0, "", 16, true},
+        {"end-g", "OXXXO--OOXXX-X-OOXOXXOOOOXOXOX--OXOOOOOOOXOXOX--XXXXXXX-O----X-X", 'X', 0, "", -26, true},
+        {"end-h", "--OOOO-O--XX-OOXXXXXXOO-XXXOXOOOXXOOXOOOX-OXOXO-XO-O-O-XX-OOOO--", 'O', 0, "", -18, true},
+        {"end-i", "--X-O---X-XOO---X-XXOO-OXOXXXOO--OXOOXOXXOOOOOXXXOOOOO-XX-XXXXXX", 'X', 0, "", 40, true},
+    };
+
+    const BenchPosition MIDGAME_SUITE[] = {
+        {"mid-a", "--O-XXX---OOX---OOOXO-----XXO-X-OOOOOO--XXXXXXO----XX------XXX--", 'X', MIDGAME_DEPTH, "h7", 4, true},
+        {"mid-b", "---X-O-XO--XO-X-O-XOOX--OXOXO-----XXO---OOOXOO----O-O-----O--O--", 'X', MIDGAME_DEPTH, "b8", 0, true},
+        {"mid-c", "--O--X----O--X--OOOOOX----XOX----XOXO---X-XOXOOO----X-------X---", 'X', MIDGAME_DEPTH, "d7", -14, true},
+        {"mid-d", "--OO-X--O-OOX-OOOOOXXOO-OOXXOXXX--OOXXX--XOOXX----O-X-----O-X---", 'X', MIDGAME_DEPTH, "b5", -16, true},
+        {"mid-e", "OOOX--X-O-XX-X--OX-XX---XOXXX----XXXXOOO-X-XX---OX-OX-----O-X---", 'X', MIDGAME_DEPTH, "g4", -68, true},
+        {"mid-f", "X-X-----X-X-----XOXOXX----XOXO----XOXO----XOOO---OOO-O--OOX--O--", 'X', MIDGAME_DEPTH, "a4", -8, true},
+        {"mid-g", "-----------O---O--XOO-O----OXOOX--XOX-O--X-OOXOO---OX-X---O-X---", 'X', MIDGAME_DEPTH, "f2", -16, true},
+        {"mid-h", "---------XX-----XXXOO----XOXXX--OXOOXX--OXOXOXXXOOXXOO--O--XOOOO", 'X', MIDGAME_DEPTH, "g7", -82, true},
+    };
+
+    bool parsePosition(const std::string &board, const char side, Position &pos) {
+        if (board.size() != 64 || (side != 'X' && side != 'O')) {
+            return false;
+        }
+
+        uint64_t black = 0, white = 0;
+        for (int square = 0; square < 64; square++) {
+            if (board[square] == 'X') {
+                black |= Bitboard::squareBit(square);
+            } else if (board[square] == 'O') {
+                white |= Bitboard::squareBit(square);
+            } else if (board[square] != '-') {
+                return false;
+            }
+        }
+        pos = side == 'O' ? Position{white, black} : Position{black, white};
+        return true;
+    }
+
+    bool readSuite(const std::string &path, std::vector<BenchPosition> &positions) {
+        std::ifstream file(path);
+        if (!file.is_open()) {
+            return false;
+        }
+
+        std::string line;
+        int lineNumber = 0;
+        while (std::getline(file, line)) {
+            lineNumber++;
+            std::istringstream fields(line);
+            std::string board, side;
+            if (!(fields >> board >> side)) {
+                continue;
+            }
+
+            BenchPosition position{path + ":" + std::to_string(lineNumber), board, side[0], 0, "", 0, false};
+            Position pos;
+            if (!parsePosition(position.board, position.side, pos)) {
+                std::cerr << position.name << ": not a position" << std::endl;
+                continue;
+            }
+
+            const size_t colon = line.find(':');
+            if (colon != std::string::npos) {
+                try {
+                    position.score = std::stoi(line.substr(colon + 1));
+                    position.checked = true;
+                } catch (const std::exception &) {
+                    std::cerr << position.name << ": unreadable score" << std::endl;
+                }
+            }
+            positions.push_back(position);
+        }
+        return true;
+    }
+
+    BenchResult run(Search &search, const BenchPosition &position) {
+        BenchResult result;
+        result.position = &position;
+
+        Position pos;
+        parsePosition(position.board, position.side, pos);
+        result.empties = Bitboard::empties(pos);
+
+        search.clear();
+        const auto start = std::chrono::steady_clock::now();
+        if (position.depth == 0) {
+            const MoveScore solved = search.solve(pos);
+            result.move = Bitboard::squareName(solved.square);
+            result.score = solved.score;
+            result.correct = solved.exact && solved.score == position.score;
+        } else {
+            const std::vector<MoveScore> moves = search.analyze(pos, position.depth, 1);
+            result.move = moves.empty() ? Bitboard::squareName(Bitboard::PASS)
+                                        : Bitboard::squareName(moves.front().square);
+            result.score = moves.empty() ? 0 : moves.front().score;
+            result.correct = result.move == position.move && result.score == position.score;
+        }
+        result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        result.nodes = search.getNodes();
+
+        if (!position.checked) {
+            result.correct = true;
+        }
+        return result;
+    }
+
+    uint64_t nodesPerSecond(const uint64_t nodes, const double seconds) {
+        return seconds > 0.0 ? static_cast<uint64_t>(nodes / seconds) : 0;
+    }
+
+    std::string jsonString(const std::string &text) {
+        std::string quoted = "\"";
+        for (const char c: text) {
+            if (c == '"' || c == '\\') {
+                quoted += '\\';
+            }
+            quoted += c;
+        }
+        return quoted + "\"";
+    }
+
+    bool writeJson(const std::string &path, const Options &options, const std::vector<BenchResult> &results,
+                   const uint64_t nodes, const double seconds, const int wrong) {
+        std::ofstream file(path);
+        if (!file.is_open()) {
+            return false;
+        }
+
+        file << "{\n"
+             << "  \"label\": " << jsonString(options.label) << ",\n"
+             << "  \"tt_megabytes\": " << options.ttMegabytes << ",\n"
+             << "  \"positions\": [\n";
+        for (size_t i = 0; i < results.size(); i++) {
+            const BenchResult &result = results[i];
+            const BenchPosition &position = *result.position;
+            file << "    {\"name\": " << jsonString(position.name)
+                 << ", \"type\": \"" << (position.depth == 0 ? "endgame" : "midgame") << "\""
+                 << ", \"empties\": " << result.empties
+                 << ", \"depth\": " << (position.depth == 0 ? result.empties : position.depth)
+                 << ", \"move\": " << jsonString(result.move)
+                 << ", \"score\": " << result.score;
+            if (position.checked) {
+                file << ", \"expected\": " << position.score;
+            }
+            file << ", \"correct\": " << (result.correct ? "true" : "false")
+                 << ", \"nodes\": " << result.nodes
+                 << ", \"seconds\": " << result.seconds
+                 << ", \"nps\": " << nodesPerSecond(result.nodes, result.seconds) << "}"
+                 << (i + 1 < results.size() ? "," : "") << '\n';
+        }
+        file << "  ],\n"
+             << "  \"total\": {\"nodes\": " << nodes
+             << ", \"seconds\": " << seconds
+             << ", \"nps\": " << nodesPerSecond(nodes, seconds)
+             << ", \"wrong\": " << wrong << "}\n"
+             << "}\n";
+        return static_cast<bool>(file);
+    }
+}
+
+int main(int argc, char *argv[]) {
+    Options options;
+
+    for (int i = 1; i < argc; i++) {
+        const std::string arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+
+        if (arg == "-t" && hasValue) {
+            const std::string suite = argv[++i];
+            options.endgame = suite == "endgame" || suite == "all";
+            options.midgame = suite == "midgame" || suite == "all";
+            if (!options.endgame && !options.midgame) {
+                std::cerr << "Unknown suite " << suite << std::endl;
+                return 1;
+            }
+        } else if (arg == "-f" && hasValue) {
+            options.suiteFile = argv[++i];
+        } else if (arg == "-m" && hasValue) {
+            options.ttMegabytes = std::stoul(argv[++i]);
+        } else if (arg == "-o" && hasValue) {
+            options.output = argv[++i];
+        } else if (arg == "-l" && hasValue) {
+            options.label = argv[++i];
+        } else {
+            std::cerr << "Usage: reversi_bench [-t endgame|midgame|all] [-f suite] [-m MB] [-o file] [-l label]"
+                      << std::endl;
+            return 1;
+        }
+    }
+
+    std::vector<BenchPosition> positions;
+    if (!options.suiteFile.empty()) {
+        if (!readSuite(options.suiteFile, positions)) {
+            std::cerr << "Can't read suite file " << options.suiteFile << std::endl;
+            return 1;
+        }
+    } else {
+        if (options.endgame) {
+            positions.insert(positions.end(), std::begin(ENDGAME_SUITE), std::end(ENDGAME_SUITE));
+        }
+        if (options.midgame) {
+            positions.insert(positions.end(), std::begin(MIDGAME_SUITE), std::end(MIDGAME_SUITE));
+        }
+    }
+
+    // A weights file next to the binary must not change the numbers
+    const Evaluation::Weights builtInWeights;
+    Search search(options.ttMegabytes);
+    search.setEvaluationWeights(builtInWeights);
+
+    std::vector<BenchResult> results;
+    uint64_t totalNodes = 0;
+    double totalSeconds = 0.0;
+    int wrong = 0;
+
+    std::cout << std::left << std::setw(10) << "position" << std::right << std::setw(8) << "empties"
+              << std::setw(7) << "move" << std::setw(8) << "score" << std::setw(14) << "nodes"
+              << std::setw(10) << "seconds" << std::setw(12) << "nps" << std::endl;
+    for (const BenchPosition &position: positions) {
+        results.push_back(run(search, position));
+        const BenchResult &result = results.back();
+        totalNodes += result.nodes;
+        totalSeconds += result.seconds;
+        wrong += result.correct ? 0 : 1;
+
+        std::cout << std::left << std::setw(10) << position.name << std::right << std::setw(8) << result.empties
+                  << std::setw(7) << result.move << std::setw(8) << result.score << std::setw(14) << result.nodes
+                  << std::setw(10) << std::fixed << std::setprecision(3) << result.seconds
+                  << std::setw(12) << nodesPerSecond(result.nodes, result.seconds);
+        if (!result.correct) {
+            std::cout << "  WRONG, expected " << (position.move.empty() ? "" : position.move + " ") << position.score;
+        }
+        std::cout << std::endl;
+    }
+
+    std::cout << results.size() << " positions, " << totalNodes << " nodes in " << totalSeconds << " s, "
+              << nodesPerSecond(totalNodes, totalSeconds) << " nps, " << wrong << " wrong" << std::endl;
+
+    if (!writeJson(options.output, options, results, totalNodes, totalSeconds, wrong)) {
+        std::cerr << "Can't write " << options.output << std::endl;
+        return 1;
+    }
+    return wrong == 0 ? 0 : 1;
+}
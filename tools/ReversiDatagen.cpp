@@ -0,0 +1,223 @@
+//
+// ReversiDatagen.cpp - fast self-play games streamed as training records
+//
+// Usage: reversi_datagen [options]
+//   -n GAMES     games to play (default 10000)
+//   -o FILE      output file (default selfplay.bin)
+//   -d DEPTH     search depth per move (default 3)
+//   -r PLIES     random opening plies (default 10)
+//   -j THREADS   worker threads (default: all cores)
+//   -s SEED      random seed (default 1)
+//   -g FILE      also write the move lists of the games (Compact.h game file)
+// Every position reached after the random opening where the side to move
+// has a legal move becomes one TrainingRecord (see TrainingData.h).
+//
+
+#include "../headers/Bitboard.h"
+#include "../headers/Compact.h"
+#include "../headers/Search.h"
+#include "../headers/TrainingData.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+    struct Options {
+        int games = 10000;
+        std::string output = "selfplay.bin";
+        int depth = 3;
+        int randomPlies = 10;
+        int threads = 0;
+        unsigned seed = 1;
+        std::string gamesOutput;
+    };
+
+    // Records a worker collects before handing them to the shared writer
+    constexpr size_t WORKER_BUFFER_RECORDS = 1 << 15;
+
+    // Shallow searches only need a small table
+    constexpr size_t WORKER_TT_MEGABYTES = 8;
+
+    int randomMove(uint64_t moves, std::mt19937_64 &rng) {
+        int skip = static_cast<int>(rng() % Bitboard::popcount(moves));
+        while (skip-- > 0) {
+            moves &= moves - 1;
+        }
+        return Bitboard::lowestSquare(moves);
+    }
+
+    /**
+     * Play one game, append its records to `records` and leave its moves,
+     * passes left out, in `played`.
+     * @return false when the game ended inside the random opening (nothing recorded)
+     */
+    bool playGame(Search &search, const Options &options, std::mt19937_64 &rng,
+                  std::vector<TrainingRecord> &records, std::vector<int> &played) {
+        Position pos = Bitboard::initial();
+        bool whiteToMove = false;
+        const size_t firstRecord = records.size();
+        played.clear();
+
+        for (int ply = 0;; ply++) {
+            const uint64_t moves = Bitboard::getMoves(pos.player, pos.opponent);
+            if (!moves) {
+                if (!Bitboard::getMoves(pos.opponent, pos.player)) {
+                    break;
+                }
+                pos = Bitboard::pass(pos);
+                whiteToMove = !whiteToMove;
+                continue;
+            }
+
+            int square;
+            if (ply < options.randomPlies) {
+                square = randomMove(moves, rng);
+            } else {
+                const std::vector<MoveScore> best = search.analyze(pos, options.depth, 1);
+                square = best.front().square;
+                const int score = best.front().score;
+
+                TrainingRecord record{};
+                record.player = pos.player;
+                record.opponent = pos.opponent;
+                record.flags = whiteToMove ? RECORD_WHITE_TO_MOVE : 0;
+                if (Search::isFinalScore(score)) {
+                    record.searchScore = static_cast<int16_t>(Search::discDifference(score));
+                    record.flags |= RECORD_EXACT_SEARCH;
+                } else {
+                    record.searchScore = static_cast<int16_t>(std::clamp(score, -32767, 32767));
+                }
+                record.empties = static_cast<uint8_t>(Bitboard::empties(pos));
+                records.push_back(record);
+            }
+
+            played.push_back(square);
+            pos = Bitboard::play(pos, square, Bitboard::getFlips(pos.player, pos.opponent, square));
+            whiteToMove = !whiteToMove;
+        }
+
+        if (records.size() == firstRecord) {
+            return false;
+        }
+
+        // Fill in the result now that the game is over
+        const int result = Search::discDifference(Search::finalScore(pos));
+        const int whiteResult = whiteToMove ? result : -result;
+        for (size_t i = firstRecord; i < records.size(); i++) {
+            const bool recordWhite = records[i].flags & RECORD_WHITE_TO_MOVE;
+            records[i].finalScore = static_cast<int8_t>(recordWhite ? whiteResult : -whiteResult);
+        }
+        return true;
+    }
+}
+
+int main(int argc, char *argv[]) {
+    Options options;
+
+    for (int i = 1; i < argc; i++) {
+        const std::string arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+
+        if (arg == "-n" && hasValue) {
+            options.games = std::stoi(argv[++i]);
+        } else if (arg == "-o" && hasValue) {
+            options.output = argv[++i];
+        } else if (arg == "-d" && hasValue) {
+            options.depth = std::stoi(argv[++i]);
+        } else if (arg == "-r" && hasValue) {
+            options.randomPlies = std::stoi(argv[++i]);
+        } else if (arg == "-j" && hasValue) {
+            options.threads = std::stoi(argv[++i]);
+        } else if (arg == "-s" && hasValue) {
+            options.seed = static_cast<unsigned>(std::stoul(argv[++i]));
+        } else if (arg == "-g" && hasValue) {
+            options.gamesOutput = argv[++i];
+        } else {
+            std::cerr << "Usage: reversi_datagen [-n games] [-o file] [-d depth] [-r plies] [-j threads] [-s seed]"
+                      << " [-g gamefile]" << std::endl;
+            return 1;
+        }
+    }
+
+    TrainingDataWriter writer;
+    if (!writer.open(options.output)) {
+        std::cerr << "Can't create " << options.output << std::endl;
+        return 1;
+    }
+
+    std::ofstream gamesFile;
+    std::mutex gamesMutex;
+    if (!options.gamesOutput.empty()) {
+        gamesFile.open(options.gamesOutput, std::ios::binary);
+        if (!gamesFile) {
+            std::cerr << "Can't create " << options.gamesOutput << std::endl;
+            return 1;
+        }
+        Compact::writeGamesHeader(gamesFile);
+    }
+
+    int threads = options.threads > 0 ? options.threads : static_cast<int>(std::thread::hardware_concurrency());
+    threads = std::max(1, threads);
+
+    std::atomic<int> nextGame{0};
+    std::atomic<int> gamesDone{0};
+    std::atomic<int> workersRunning{threads};
+    const auto startTime = std::chrono::steady_clock::now();
+
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; t++) {
+        workers.emplace_back([&, t]() {
+            Search search(WORKER_TT_MEGABYTES);
+            std::mt19937_64 rng(options.seed * 0x9E3779B97F4A7C15ULL + t);
+            std::vector<TrainingRecord> records;
+            records.reserve(WORKER_BUFFER_RECORDS + 64);
+            std::vector<int> played;
+
+            while (nextGame++ < options.games) {
+                playGame(search, options, rng, records, played);
+                if (gamesFile.is_open()) {
+                    std::lock_guard<std::mutex> lock(gamesMutex);
+                    Compact::writeGame(gamesFile, played);
+                }
+                gamesDone++;
+                if (records.size() >= WORKER_BUFFER_RECORDS) {
+                    writer.write(records);
+                    records.clear();
+                }
+            }
+            writer.write(records);
+            workersRunning--;
+        });
+    }
+
+    // Progress report while the workers run
+    auto lastReport = startTime;
+    while (workersRunning > 0) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+        const auto now = std::chrono::steady_clock::now();
+        if (now - lastReport >= std::chrono::seconds(5)) {
+            lastReport = now;
+            std::cerr << gamesDone << " / " << options.games << " games, " << writer.getRecordsWritten()
+                      << " records written" << std::endl;
+        }
+    }
+    for (std::thread &worker: workers) {
+        worker.join();
+    }
+    writer.close();
+
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    const uint64_t records = writer.getRecordsWritten();
+    std::cout << gamesDone << " games, " << records << " positions in " << seconds << " s ("
+              << static_cast<uint64_t>(records / std::max(seconds, 1e-9)) << " positions/s, " << threads
+              << " threads) -> " << options.output << std::endl;
+    return 0;
+}
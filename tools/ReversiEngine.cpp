@@ -0,0 +1,391 @@
+//
+// ReversiEngine.cpp - headless engine speaking a line protocol over stdin/stdout
+//
+// NBoard commands:
+//   nboard <version>        handshake, answered with "set myname"
+//   set depth <n>           search depth in plies
+//   set game <ggf>          position from a GGF game (BO[...] plus B[..]/W[..] moves)
+//   set contempt <n>        accepted and ignored
+//   move <sq>[/eval/time]   play a move ("pa" passes)
+//   hint <n>                score the n best moves: "search <sq> <eval> 0 <depth>" lines
+//   go                      search the best move: "=== <sq>/<eval>/<seconds>"
+//   ping <n>                abort any search, answer "pong <n>"
+//   learn                   answered with "learned"
+// Extensions:
+//   set time <seconds>      per-move time limit, 0 for none
+//   set position <64 chars> <side>   board as '*'/'X' black, 'O' white, '-'/'.' empty; side '*' or 'O'
+//   set cache <file>        share exact endgame results through a cache file, created when missing
+//   stop                    end the running search now and report its result
+//   quit
+// While searching, "status" and "nodestats" lines report every completed depth.
+//
+
+#include "../headers/Bitboard.h"
+#include "../headers/EndgameCache.h"
+#include "../headers/Search.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <condition_variable>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+    constexpr int DEFAULT_DEPTH = 12;
+    constexpr size_t ENGINE_TT_MEGABYTES = 64;
+
+    // Scores in discs for the GUI; evaluation units are close to a disc each
+    std::string formatEval(const int score) {
+        return std::to_string(Search::isFinalScore(score) ? Search::discDifference(score) : score);
+    }
+
+    class Engine {
+    public:
+        Engine() : search(ENGINE_TT_MEGABYTES) {
+        }
+
+        ~Engine() {
+            abort();
+        }
+
+        // Handle one input line; false on quit
+        bool command(const std::string &line);
+
+    private:
+        enum class Task { GO, HINT };
+
+        void send(const std::string &text);
+
+        // Start a search on the worker thread; the main thread keeps reading commands
+        void start(Task task, int hintCount);
+
+        // Let a running search finish early and print its result
+        void stop();
+
+        // Stop a running search and throw its result away
+        void abort();
+
+        void join();
+
+        void run(Task task, int hintCount, Position root, bool rootWhite);
+
+        bool setGame(const std::string &ggf);
+
+        bool setPosition(const std::string &board, const std::string &side);
+
+        bool playMove(const std::string &text);
+
+        EndgameCache endgameCache;
+        Search search;
+        Position pos = Bitboard::initial();
+        bool whiteToMove = false;
+        int depth = DEFAULT_DEPTH;
+        double moveSeconds = 0.0;
+
+        std::thread worker;
+        std::mutex outputMutex;
+
+        // Wakes the time limit wait when the search ends first
+        std::mutex doneMutex;
+        std::condition_variable doneSignal;
+        bool done = true;
+        std::atomic<bool> discard{false};
+    };
+
+    void Engine::send(const std::string &text) {
+        std::lock_guard<std::mutex> lock(outputMutex);
+        std::cout << text << std::endl;
+    }
+
+    void Engine::join() {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+
+    void Engine::stop() {
+        search.requestStop();
+        join();
+    }
+
+    void Engine::abort() {
+        discard = true;
+        stop();
+        discard = false;
+    }
+
+    void Engine::start(const Task task, const int hintCount) {
+        abort();
+        search.clearStop();
+        {
+            std::lock_guard<std::mutex> lock(doneMutex);
+            done = false;
+        }
+        worker = std::thread(&Engine::run, this, task, hintCount, pos, whiteToMove);
+    }
+
+    void Engine::run(const Task task, const int hintCount, Position root, const bool rootWhite) {
+        const auto startTime = std::chrono::steady_clock::now();
+
+        // Enforce the time limit from a helper so the search itself stays unaware of clocks
+        std::thread timer;
+        if (moveSeconds > 0.0) {
+            timer = std::thread([this]() {
+                std::unique_lock<std::mutex> lock(doneMutex);
+                if (!doneSignal.wait_for(lock, std::chrono::duration<double>(moveSeconds), [this]() { return done; })) {
+                    search.requestStop();
+                }
+            });
+        }
+
+        send(task == Task::GO ? "status Thinking" : "status Analyzing");
+
+        std::vector<MoveScore> moves;
+        bool mustPass = !Bitboard::getMoves(root.player, root.opponent);
+        if (!mustPass) {
+            const int multiPV = task == Task::GO ? 1 : hintCount;
+            moves = search.analyze(root, depth, multiPV, [&](const AnalysisInfo &info) {
+                if (discard) {
+                    return;
+                }
+                std::ostringstream out;
+                out << "status " << (rootWhite ? "White" : "Black") << " depth " << info.depth << ": "
+                    << Bitboard::squareName(info.moves.front().square) << ' ' << formatEval(info.moves.front().score);
+                send(out.str());
+                send("nodestats " + std::to_string(info.nodes) + " " + std::to_string(info.seconds));
+                if (task == Task::HINT) {
+                    for (const MoveScore &move: info.moves) {
+                        send("search " + Bitboard::squareName(move.square) + " " + formatEval(move.score) + " 0 "
+                             + std::to_string(info.depth));
+                    }
+                }
+            });
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(doneMutex);
+            done = true;
+        }
+        doneSignal.notify_all();
+        if (timer.joinable()) {
+            timer.join();
+        }
+
+        if (discard) {
+            return;
+        }
+
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+        if (task == Task::GO) {
+            if (mustPass || moves.empty()) {
+                send("=== pa");
+            } else {
+                send("=== " + Bitboard::squareName(moves.front().square) + "/" + formatEval(moves.front().score)
+                     + "/" + std::to_string(seconds));
+            }
+        } else if (mustPass) {
+            send("search pa 0 0 0");
+        }
+        send("status");
+    }
+
+    bool Engine::playMove(const std::string &text) {
+        const std::string name = text.substr(0, text.find('/'));
+        if (name == "pa" || name == "PA" || name == "PASS" || name == "pass") {
+            if (Bitboard::getMoves(pos.player, pos.opponent)) {
+                return false;
+            }
+            pos = Bitboard::pass(pos);
+            whiteToMove = !whiteToMove;
+            return true;
+        }
+
+        const int square = Bitboard::parseSquare(name);
+        if (square < 0 || ((pos.player | pos.opponent) & Bitboard::squareBit(square))) {
+            return false;
+        }
+        const uint64_t flips = Bitboard::getFlips(pos.player, pos.opponent, square);
+        if (!flips) {
+            return false;
+        }
+
+        pos = Bitboard::play(pos, square, flips);
+        whiteToMove = !whiteToMove;
+        return true;
+    }
+
+    bool Engine::setPosition(const std::string &board, const std::string &side) {
+        if (board.size() != 64 || side.empty()) {
+            return false;
+        }
+
+        uint64_t black = 0, white = 0;
+        for (int square = 0; square < 64; square++) {
+            const char c = board[square];
+            if (c == '*' || c == 'X' || c == 'x' || c == 'B' || c == 'b') {
+                black |= Bitboard::squareBit(square);
+            } else if (c == 'O' || c == 'o' || c == 'W' || c == 'w') {
+                white |= Bitboard::squareBit(square);
+            } else if (c != '-' && c != '.') {
+                return false;
+            }
+        }
+
+        const char s = side[0];
+        whiteToMove = s == 'O' || s == 'o' || s == 'W' || s == 'w';
+        pos = whiteToMove ? Position{white, black} : Position{black, white};
+        return true;
+    }
+
+    bool Engine::setGame(const std::string &ggf) {
+        pos = Bitboard::initial();
+        whiteToMove = false;
+
+        // Walk TAG[value] pairs; the board comes first, moves follow in order
+        size_t i = 0;
+        while ((i = ggf.find('[', i)) != std::string::npos) {
+            size_t tagStart = i;
+            while (tagStart > 0 && std::isupper(static_cast<unsigned char>(ggf[tagStart - 1]))) {
+                tagStart--;
+            }
+            const std::string tag = ggf.substr(tagStart, i - tagStart);
+            const size_t end = ggf.find(']', i);
+            if (end == std::string::npos) {
+                return false;
+            }
+            const std::string value = ggf.substr(i + 1, end - i - 1);
+            i = end + 1;
+
+            if (tag == "BO") {
+                std::istringstream in(value);
+                std::string size, row, board, side;
+                in >> size;
+                if (size != "8") {
+                    return false;
+                }
+                while (board.size() < 64 && in >> row) {
+                    board += row;
+                }
+                in >> side;
+                if (!setPosition(board, side)) {
+                    return false;
+                }
+            } else if (tag == "B" || tag == "W") {
+                if ((tag == "W") != whiteToMove && !Bitboard::getMoves(pos.player, pos.opponent)) {
+                    // Implicit pass in the record
+                    pos = Bitboard::pass(pos);
+                    whiteToMove = !whiteToMove;
+                }
+                if (!playMove(value)) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    bool Engine::command(const std::string &line) {
+        std::istringstream in(line);
+        std::string word;
+        if (!(in >> word)) {
+            return true;
+        }
+
+        if (word == "quit") {
+            abort();
+            return false;
+        }
+        if (word == "stop") {
+            stop();
+            return true;
+        }
+        if (word == "ping") {
+            std::string n;
+            in >> n;
+            abort();
+            send("pong " + n);
+            return true;
+        }
+
+        // Everything else changes or reads the position, so no search may be running
+        abort();
+
+        if (word == "nboard") {
+            send("set myname Reversi");
+        } else if (word == "learn") {
+            send("learned");
+        } else if (word == "go") {
+            start(Task::GO, 1);
+        } else if (word == "hint") {
+            int count = 1;
+            in >> count;
+            start(Task::HINT, std::max(1, count));
+        } else if (word == "move") {
+            std::string move;
+            in >> move;
+            if (!playMove(move)) {
+                send("status Illegal move " + move);
+            }
+        } else if (word == "set") {
+            std::string what;
+            in >> what;
+            if (what == "depth") {
+                int value = depth;
+                in >> value;
+                depth = std::max(1, value);
+            } else if (what == "time") {
+                double value = 0.0;
+                in >> value;
+                moveSeconds = std::max(0.0, value);
+            } else if (what == "game") {
+                std::string ggf;
+                std::getline(in, ggf);
+                if (!setGame(ggf)) {
+                    send("status Unreadable game");
+                }
+            } else if (what == "position") {
+                std::string board, side;
+                in >> board >> side;
+                if (!setPosition(board, side)) {
+                    send("status Unreadable position");
+                }
+            } else if (what == "cache") {
+                std::string path;
+                in >> path;
+                if (endgameCache.open(path)) {
+                    search.setEndgameCache(&endgameCache);
+                } else {
+                    search.setEndgameCache(nullptr);
+                    send("status Can't open endgame cache " + path);
+                }
+            } else if (what != "contempt") {
+                send("status Unknown setting " + what);
+            }
+        } else {
+            send("status Unknown command " + word);
+        }
+        return true;
+    }
+}
+
+int main() {
+    std::ios::sync_with_stdio(false);
+
+    Engine engine;
+    std::string line;
+    while (std::getline(std::cin, line)) {
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+        if (!engine.command(line)) {
+            break;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,370 @@
+//
+// ReversiLatency.cpp - how long the game's AI takes per move, by level and game phase
+//
+// Usage: reversi_latency [options]
+//   -n GAMES     games per level (default 20)
+//   -a LEVELS    comma separated: easy, medium, hard, hard+, mcts (default easy,medium,hard)
+//   -c SECONDS   play on the game clock with this much time per move, 0 for none (default 0)
+//   -r MOVES     random opening moves of the black opponent (default 6)
+//   -d DEPTH     search depth of the black opponent after the opening (default 3)
+//   -w COUNT     slowest positions kept per level (default 10)
+//   -s SEED      random seed (default 1)
+//   -o FILE      result file, CSV when the name ends in .csv, else JSON (default reversi_latency.json)
+// The AI plays white through FundamentalFunction::AIPlayChess, exactly as in
+// the game, and every call is timed. Times are reported as p50/p95/p99/max
+// in milliseconds over the whole game, per 10 move numbers and per 10
+// empties. The slowest positions are written as "<64 chars> O", the layout
+// reversi_bench and reversi_engine read, to reproduce them. Games run one at
+// a time so the timings do not compete for the CPU.
+//
+
+#include "../headers/Bitboard.h"
+#include "../headers/FundamentalFunction.h"
+#include "../headers/Search.h"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iterator>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+    struct Options {
+        int games = 20;
+        std::vector<AILevel> levels{AILevel::EASY, AILevel::MEDIUM, AILevel::HARD};
+        double clockSeconds = 0.0;
+        int randomMoves = 6;
+        int opponentDepth = 3;
+        int worst = 10;
+        unsigned seed = 1;
+        std::string output = "reversi_latency.json";
+    };
+
+    // Width of the move number and empties buckets
+    constexpr int BUCKET = 10;
+
+    // Timeouts the AI may still afford on the game clock, as at the start of a game
+    constexpr int CLOCK_CHANCES = 3;
+
+    // One timed AI move
+    struct Sample {
+        double milliseconds;
+        int moveNumber;     // plies played before it, plus one
+        int empties;
+        std::string board;
+    };
+
+    struct Distribution {
+        size_t count = 0;
+        double p50 = 0.0, p95 = 0.0, p99 = 0.0, max = 0.0;
+    };
+
+    struct Bucket {
+        int from;
+        int to;
+        Distribution times;
+    };
+
+    struct LevelReport {
+        AILevel level;
+        Distribution all;
+        std::vector<Bucket> byMove;
+        std::vector<Bucket> byEmpties;
+        std::vector<Sample> worst;
+    };
+
+    const char *levelName(const AILevel level) {
+        switch (level) {
+            case AILevel::EASY:
+                return "easy";
+            case AILevel::MEDIUM:
+                return "medium";
+            case AILevel::HARD:
+                return "hard";
+            case AILevel::HARD_PLUS:
+                return "hard+";
+            case AILevel::MCTS:
+            default:
+                return "mcts";
+        }
+    }
+
+    bool parseLevels(const std::string &text, std::vector<AILevel> &levels) {
+        const AILevel all[] = {AILevel::EASY, AILevel::MEDIUM, AILevel::HARD, AILevel::HARD_PLUS, AILevel::MCTS};
+
+        levels.clear();
+        std::istringstream names(text);
+        std::string name;
+        while (std::getline(names, name, ',')) {
+            const AILevel *level = std::find_if(std::begin(all), std::end(all), [&](const AILevel candidate) {
+                return name == levelName(candidate);
+            });
+            if (level == std::end(all)) {
+                return false;
+            }
+            levels.push_back(*level);
+        }
+        return !levels.empty();
+    }
+
+    std::string boardText(const Position &white) {
+        std::string text(64, '-');
+        for (int square = 0; square < 64; square++) {
+            if (white.opponent & Bitboard::squareBit(square)) {
+                text[square] = 'X';
+            } else if (white.player & Bitboard::squareBit(square)) {
+                text[square] = 'O';
+            }
+        }
+        return text + " O";
+    }
+
+    // Nearest-rank percentiles of `milliseconds`
+    Distribution distribution(std::vector<double> milliseconds) {
+        Distribution result;
+        result.count = milliseconds.size();
+        if (milliseconds.empty()) {
+            return result;
+        }
+
+        std::sort(milliseconds.begin(), milliseconds.end());
+        const auto rank = [&](const double percent) {
+            const size_t index = static_cast<size_t>(percent / 100.0 * static_cast<double>(milliseconds.size()) + 0.999999);
+            return milliseconds[std::min(milliseconds.size(), std::max<size_t>(1, index)) - 1];
+        };
+        result.p50 = rank(50);
+        result.p95 = rank(95);
+        result.p99 = rank(99);
+        result.max = milliseconds.back();
+        return result;
+    }
+
+    std::vector<Bucket> buckets(const std::vector<Sample> &samples, int Sample::*key) {
+        int highest = 0;
+        for (const Sample &sample: samples) {
+            highest = std::max(highest, sample.*key);
+        }
+
+        std::vector<Bucket> result;
+        for (int from = 0; from <= highest; from += BUCKET) {
+            std::vector<double> times;
+            for (const Sample &sample: samples) {
+                if (sample.*key >= from && sample.*key < from + BUCKET) {
+                    times.push_back(sample.milliseconds);
+                }
+            }
+            if (!times.empty()) {
+                result.push_back({from, from + BUCKET - 1, distribution(times)});
+            }
+        }
+        return result;
+    }
+
+    int randomMove(uint64_t moves, std::mt19937_64 &rng) {
+        int skip = static_cast<int>(rng() % Bitboard::popcount(moves));
+        while (skip-- > 0) {
+            moves &= moves - 1;
+        }
+        return Bitboard::lowestSquare(moves);
+    }
+
+    // Play one game with the AI as white and append the time of each of its moves
+    void playGame(FundamentalFunction &game, Search &opponent, const Options &options, std::mt19937_64 &rng,
+                  std::vector<Sample> &samples) {
+        game.initialize();
+        bool isWhiteTurn = false;
+        int blackMoves = 0;
+
+        for (int ply = 0; !game.isGameOver();) {
+            if (game.mustPass(isWhiteTurn)) {
+                isWhiteTurn = !isWhiteTurn;
+                continue;
+            }
+
+            const Position pos = Bitboard::fromBoard(game.board, isWhiteTurn);
+            int x, y;
+            if (isWhiteTurn) {
+                const auto start = std::chrono::steady_clock::now();
+                const std::pair<int, int> move = options.clockSeconds > 0.0
+                                                     ? game.AIPlayChess(options.clockSeconds, CLOCK_CHANCES)
+                                                     : game.AIPlayChess();
+                const double milliseconds = std::chrono::duration<double, std::milli>(
+                    std::chrono::steady_clock::now() - start).count();
+
+                samples.push_back({milliseconds, ply + 1, Bitboard::empties(pos), boardText(pos)});
+                x = move.first;
+                y = move.second;
+            } else {
+                const uint64_t moves = Bitboard::getMoves(pos.player, pos.opponent);
+                const int square = blackMoves++ < options.randomMoves
+                                       ? randomMove(moves, rng)
+                                       : opponent.bestMove(pos, options.opponentDepth);
+                x = square % Bitboard::SIZE;
+                y = square / Bitboard::SIZE;
+            }
+
+            game.turnOver(x, y, isWhiteTurn);
+            isWhiteTurn = !isWhiteTurn;
+            ply++;
+        }
+    }
+
+    LevelReport measure(const AILevel level, const Options &options) {
+        FundamentalFunction game;
+        game.setAIDifficulty(level);
+        game.setRandomSeed(options.seed);
+        Search opponent(8);
+        std::mt19937_64 rng(options.seed);
+
+        std::vector<Sample> samples;
+        for (int i = 0; i < options.games; i++) {
+            playGame(game, opponent, options, rng, samples);
+        }
+
+        LevelReport report;
+        report.level = level;
+
+        std::vector<double> times;
+        for (const Sample &sample: samples) {
+            times.push_back(sample.milliseconds);
+        }
+        report.all = distribution(times);
+        report.byMove = buckets(samples, &Sample::moveNumber);
+        report.byEmpties = buckets(samples, &Sample::empties);
+
+        std::sort(samples.begin(), samples.end(), [](const Sample &a, const Sample &b) {
+            return a.milliseconds > b.milliseconds;
+        });
+        samples.resize(std::min(samples.size(), static_cast<size_t>(std::max(0, options.worst))));
+        report.worst = samples;
+        return report;
+    }
+
+    void printDistribution(std::ostream &out, const Distribution &times) {
+        out << "\"count\": " << times.count << ", \"p50\": " << times.p50 << ", \"p95\": " << times.p95
+            << ", \"p99\": " << times.p99 << ", \"max\": " << times.max;
+    }
+
+    void writeJsonBuckets(std::ostream &out, const char *name, const std::vector<Bucket> &list) {
+        out << "      \"" << name << "\": [\n";
+        for (size_t i = 0; i < list.size(); i++) {
+            out << "        {\"from\": " << list[i].from << ", \"to\": " << list[i].to << ", ";
+            printDistribution(out, list[i].times);
+            out << "}" << (i + 1 < list.size() ? "," : "") << '\n';
+        }
+        out << "      ],\n";
+    }
+
+    void writeJson(std::ostream &out, const Options &options, const std::vector<LevelReport> &reports) {
+        out << "{\n"
+            << "  \"games_per_level\": " << options.games << ",\n"
+            << "  \"clock_seconds\": " << options.clockSeconds << ",\n"
+            << "  \"levels\": [\n";
+        for (size_t r = 0; r < reports.size(); r++) {
+            const LevelReport &report = reports[r];
+            out << "    {\n"
+                << "      \"level\": \"" << levelName(report.level) << "\",\n"
+                << "      \"all\": {";
+            printDistribution(out, report.all);
+            out << "},\n";
+            writeJsonBuckets(out, "by_move", report.byMove);
+            writeJsonBuckets(out, "by_empties", report.byEmpties);
+
+            out << "      \"worst\": [\n";
+            for (size_t i = 0; i < report.worst.size(); i++) {
+                const Sample &sample = report.worst[i];
+                out << "        {\"ms\": " << sample.milliseconds << ", \"move\": " << sample.moveNumber
+                    << ", \"empties\": " << sample.empties << ", \"board\": \"" << sample.board << "\"}"
+                    << (i + 1 < report.worst.size() ? "," : "") << '\n';
+            }
+            out << "      ]\n"
+                << "    }" << (r + 1 < reports.size() ? "," : "") << '\n';
+        }
+        out << "  ]\n"
+            << "}\n";
+    }
+
+    // One row per level and bucket; the worst positions only go to JSON
+    void writeCsv(std::ostream &out, const std::vector<LevelReport> &reports) {
+        out << "level,bucket,from,to,count,p50_ms,p95_ms,p99_ms,max_ms\n";
+        const auto row = [&](const LevelReport &report, const char *bucket, const int from, const int to,
+                             const Distribution &times) {
+            out << levelName(report.level) << ',' << bucket << ',' << from << ',' << to << ',' << times.count << ','
+                << times.p50 << ',' << times.p95 << ',' << times.p99 << ',' << times.max << '\n';
+        };
+
+        for (const LevelReport &report: reports) {
+            row(report, "all", 0, 0, report.all);
+            for (const Bucket &bucket: report.byMove) {
+                row(report, "move", bucket.from, bucket.to, bucket.times);
+            }
+            for (const Bucket &bucket: report.byEmpties) {
+                row(report, "empties", bucket.from, bucket.to, bucket.times);
+            }
+        }
+    }
+}
+
+int main(int argc, char *argv[]) {
+    Options options;
+
+    for (int i = 1; i < argc; i++) {
+        const std::string arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+
+        if (arg == "-n" && hasValue) {
+            options.games = std::stoi(argv[++i]);
+        } else if (arg == "-a" && hasValue) {
+            if (!parseLevels(argv[++i], options.levels)) {
+                std::cerr << "Levels are easy, medium, hard, hard+ and mcts" << std::endl;
+                return 1;
+            }
+        } else if (arg == "-c" && hasValue) {
+            options.clockSeconds = std::stod(argv[++i]);
+        } else if (arg == "-r" && hasValue) {
+            options.randomMoves = std::stoi(argv[++i]);
+        } else if (arg == "-d" && hasValue) {
+            options.opponentDepth = std::stoi(argv[++i]);
+        } else if (arg == "-w" && hasValue) {
+            options.worst = std::stoi(argv[++i]);
+        } else if (arg == "-s" && hasValue) {
+            options.seed = static_cast<unsigned>(std::stoul(argv[++i]));
+        } else if (arg == "-o" && hasValue) {
+            options.output = argv[++i];
+        } else {
+            std::cerr << "Usage: reversi_latency [-n games] [-a levels] [-c seconds] [-r moves] [-d depth]"
+                         " [-w count] [-s seed] [-o file]" << std::endl;
+            return 1;
+        }
+    }
+
+    std::vector<LevelReport> reports;
+    for (const AILevel level: options.levels) {
+        const auto start = std::chrono::steady_clock::now();
+        reports.push_back(measure(level, options));
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        const Distribution &all = reports.back().all;
+        std::cout << levelName(level) << ": " << all.count << " moves in " << seconds << " s, p50 " << all.p50
+                  << " ms, p95 " << all.p95 << " ms, p99 " << all.p99 << " ms, max " << all.max << " ms"
+                  << std::endl;
+    }
+
+    std::ofstream file(options.output);
+    if (!file.is_open()) {
+        std::cerr << "Can't write " << options.output << std::endl;
+        return 1;
+    }
+
+    const bool csv = options.output.size() >= 4 && options.output.compare(options.output.size() - 4, 4, ".csv") == 0;
+    if (csv) {
+        writeCsv(file, reports);
+    } else {
+        writeJson(file, options, reports);
+    }
+    return file ? 0 : 1;
+}
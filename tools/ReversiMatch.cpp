@@ -0,0 +1,307 @@
+//
+// ReversiMatch.cpp - self-play match between two engine configurations with Elo and SPRT
+//
+// Usage: reversi_match [options] ENGINE_A ENGINE_B
+//   ENGINE       comma separated settings, e.g. "depth=8" or "depth=6,tt=32"
+//   -g GAMES     games to play, rounded up to an even number (default 400)
+//   -j THREADS   parallel games (default: all cores)
+//   -p PLIES     random plies in the balanced openings (default 6)
+//   -s SEED      opening selection seed (default 1)
+//   --elo0 E, --elo1 E, --alpha A, --beta B   SPRT hypotheses (default 0, 10, 0.05, 0.05)
+// Every opening is played twice with colours swapped. The match stops early
+// once the SPRT accepts either hypothesis.
+//
+
+#include "../headers/Bitboard.h"
+#include "../headers/Search.h"
+#include "../headers/Symmetry.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+    struct EngineConfig {
+        std::string name;
+        int depth = 8;
+        size_t ttMegabytes = 16;
+    };
+
+    struct Options {
+        int games = 400;
+        int threads = 0;
+        int openingPlies = 6;
+        unsigned seed = 1;
+        double elo0 = 0.0;
+        double elo1 = 10.0;
+        double alpha = 0.05;
+        double beta = 0.05;
+    };
+
+    // Openings whose shallow score stays within this many evaluation units of even
+    constexpr int BALANCED_MARGIN = 4;
+    constexpr int BALANCE_DEPTH = 6;
+
+    bool parseEngine(const std::string &text, EngineConfig &config) {
+        config.name = text;
+
+        std::istringstream in(text);
+        std::string item;
+        while (std::getline(in, item, ',')) {
+            const size_t eq = item.find('=');
+            if (eq == std::string::npos) {
+                return false;
+            }
+            const std::string key = item.substr(0, eq);
+            const std::string value = item.substr(eq + 1);
+            try {
+                if (key == "depth") {
+                    config.depth = std::stoi(value);
+                } else if (key == "tt") {
+                    config.ttMegabytes = std::stoul(value);
+                } else {
+                    return false;
+                }
+            } catch (const std::exception &) {
+                return false;
+            }
+        }
+        return config.depth > 0;
+    }
+
+    /**
+     * One position per symmetry class reached after `plies` moves from the
+     * start whose shallow search score is close to even, shuffled with `seed`.
+     */
+    std::vector<Position> balancedOpenings(const int plies, const unsigned seed) {
+        std::vector<Position> frontier = {Bitboard::initial()};
+        for (int ply = 0; ply < plies; ply++) {
+            std::vector<Position> next;
+            for (const Position &pos: frontier) {
+                uint64_t moves = Bitboard::getMoves(pos.player, pos.opponent);
+                while (moves) {
+                    const int square = Bitboard::lowestSquare(moves);
+                    moves &= moves - 1;
+                    next.push_back(Symmetry::canonical(
+                        Bitboard::play(pos, square, Bitboard::getFlips(pos.player, pos.opponent, square))));
+                }
+            }
+            std::sort(next.begin(), next.end(), Symmetry::less);
+            next.erase(std::unique(next.begin(), next.end()), next.end());
+            frontier.swap(next);
+        }
+
+        Search search(16);
+        std::vector<Position> openings;
+        for (const Position &pos: frontier) {
+            const std::vector<MoveScore> best = search.analyze(pos, BALANCE_DEPTH, 1);
+            if (!best.empty() && std::abs(best.front().score) <= BALANCED_MARGIN) {
+                openings.push_back(pos);
+            }
+        }
+
+        std::mt19937 rng(seed);
+        std::shuffle(openings.begin(), openings.end(), rng);
+        return openings;
+    }
+
+    /**
+     * Play one game from `start` to the end.
+     * @return final disc difference for the side to move in `start`
+     */
+    int playGame(const Position &start, Search &first, const EngineConfig &firstConfig,
+                 Search &second, const EngineConfig &secondConfig) {
+        Position pos = start;
+        bool firstToMove = true;
+
+        for (;;) {
+            if (!Bitboard::getMoves(pos.player, pos.opponent)) {
+                if (!Bitboard::getMoves(pos.opponent, pos.player)) {
+                    const int score = Search::discDifference(Search::finalScore(pos));
+                    return firstToMove ? score : -score;
+                }
+                pos = Bitboard::pass(pos);
+                firstToMove = !firstToMove;
+                continue;
+            }
+
+            const int square = firstToMove ? first.bestMove(pos, firstConfig.depth)
+                                           : second.bestMove(pos, secondConfig.depth);
+            pos = Bitboard::play(pos, square, Bitboard::getFlips(pos.player, pos.opponent, square));
+            firstToMove = !firstToMove;
+        }
+    }
+
+    // Expected score of the stronger side for an Elo difference
+    double expectedScore(const double elo) {
+        return 1.0 / (1.0 + std::pow(10.0, -elo / 400.0));
+    }
+
+    double eloFromScore(const double score) {
+        const double clamped = std::min(std::max(score, 1e-6), 1.0 - 1e-6);
+        return -400.0 * std::log10(1.0 / clamped - 1.0);
+    }
+
+    struct MatchStats {
+        int wins = 0;
+        int draws = 0;
+        int losses = 0;
+
+        int games() const { return wins + draws + losses; }
+
+        double score() const { return (wins + 0.5 * draws) / games(); }
+
+        // Per-game variance of the score
+        double variance() const {
+            const double s = score();
+            return (wins * (1.0 - s) * (1.0 - s) + draws * (0.5 - s) * (0.5 - s) + losses * s * s) / games();
+        }
+
+        /**
+         * Log-likelihood ratio of elo1 against elo0, using the normal
+         * approximation of the trinomial game outcome (GSPRT).
+         */
+        double llr(const double elo0, const double elo1) const {
+            const double var = variance();
+            if (games() == 0 || var <= 0.0) {
+                return 0.0;
+            }
+            const double s0 = expectedScore(elo0);
+            const double s1 = expectedScore(elo1);
+            return games() * (s1 - s0) * (2.0 * score() - s0 - s1) / (2.0 * var);
+        }
+    };
+}
+
+int main(int argc, char *argv[]) {
+    Options options;
+    std::vector<std::string> engines;
+
+    for (int i = 1; i < argc; i++) {
+        const std::string arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+
+        if (arg == "-g" && hasValue) {
+            options.games = std::stoi(argv[++i]);
+        } else if (arg == "-j" && hasValue) {
+            options.threads = std::stoi(argv[++i]);
+        } else if (arg == "-p" && hasValue) {
+            options.openingPlies = std::stoi(argv[++i]);
+        } else if (arg == "-s" && hasValue) {
+            options.seed = static_cast<unsigned>(std::stoul(argv[++i]));
+        } else if (arg == "--elo0" && hasValue) {
+            options.elo0 = std::stod(argv[++i]);
+        } else if (arg == "--elo1" && hasValue) {
+            options.elo1 = std::stod(argv[++i]);
+        } else if (arg == "--alpha" && hasValue) {
+            options.alpha = std::stod(argv[++i]);
+        } else if (arg == "--beta" && hasValue) {
+            options.beta = std::stod(argv[++i]);
+        } else if (!arg.empty() && arg[0] != '-') {
+            engines.push_back(arg);
+        } else {
+            engines.clear();
+            break;
+        }
+    }
+
+    EngineConfig configs[2];
+    if (engines.size() != 2 || !parseEngine(engines[0], configs[0]) || !parseEngine(engines[1], configs[1])) {
+        std::cerr << "Usage: reversi_match [-g games] [-j threads] [-p plies] [-s seed] [--elo0 E] [--elo1 E] "
+                     "[--alpha A] [--beta B] ENGINE_A ENGINE_B\n"
+                     "  ENGINE: depth=N[,tt=MB]" << std::endl;
+        return 1;
+    }
+
+    const std::vector<Position> openings = balancedOpenings(options.openingPlies, options.seed);
+    if (openings.empty()) {
+        std::cerr << "No balanced openings at " << options.openingPlies << " plies" << std::endl;
+        return 1;
+    }
+
+    const int pairs = std::max(1, (options.games + 1) / 2);
+    if (pairs > static_cast<int>(openings.size())) {
+        std::cerr << "Only " << openings.size() << " balanced openings, some are played more than once" << std::endl;
+    }
+
+    int threads = options.threads > 0 ? options.threads : static_cast<int>(std::thread::hardware_concurrency());
+    threads = std::max(1, std::min(threads, pairs * 2));
+
+    const double lowerBound = std::log(options.beta / (1.0 - options.alpha));
+    const double upperBound = std::log((1.0 - options.beta) / options.alpha);
+
+    std::cout << configs[0].name << " vs " << configs[1].name << ": " << pairs * 2 << " games from "
+              << openings.size() << " openings, " << threads << " threads" << std::endl;
+
+    MatchStats stats;
+    std::mutex statsMutex;
+    std::atomic<int> nextGame{0};
+    std::atomic<bool> decided{false};
+
+    // Game 2k and 2k+1 share an opening; A moves first in the even game
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; t++) {
+        workers.emplace_back([&]() {
+            Search searchA(configs[0].ttMegabytes);
+            Search searchB(configs[1].ttMegabytes);
+
+            for (int game = nextGame++; game < pairs * 2 && !decided; game = nextGame++) {
+                const Position &start = openings[(game / 2) % openings.size()];
+                searchA.clear();
+                searchB.clear();
+
+                const bool aFirst = game % 2 == 0;
+                const int result = aFirst
+                                       ? playGame(start, searchA, configs[0], searchB, configs[1])
+                                       : -playGame(start, searchB, configs[1], searchA, configs[0]);
+
+                std::lock_guard<std::mutex> lock(statsMutex);
+                if (result > 0) {
+                    stats.wins++;
+                } else if (result < 0) {
+                    stats.losses++;
+                } else {
+                    stats.draws++;
+                }
+
+                const double llr = stats.llr(options.elo0, options.elo1);
+                if (llr <= lowerBound || llr >= upperBound) {
+                    decided = true;
+                }
+                if (stats.games() % 20 == 0 || decided) {
+                    std::cout << "games " << stats.games() << ": +" << stats.wins << " =" << stats.draws << " -"
+                              << stats.losses << "  llr " << llr << std::endl;
+                }
+            }
+        });
+    }
+    for (std::thread &worker: workers) {
+        worker.join();
+    }
+
+    // 95% interval of the mean score, mapped through the Elo curve
+    const double score = stats.score();
+    const double margin = 1.96 * std::sqrt(stats.variance() / stats.games());
+    const double elo = eloFromScore(score);
+    const double eloLow = eloFromScore(score - margin);
+    const double eloHigh = eloFromScore(score + margin);
+    const double llr = stats.llr(options.elo0, options.elo1);
+
+    std::cout << "\n" << configs[0].name << " vs " << configs[1].name << "\n"
+              << "games " << stats.games() << ": +" << stats.wins << " =" << stats.draws << " -" << stats.losses
+              << "  score " << score * 100.0 << "%\n"
+              << "elo " << elo << " +/- " << (eloHigh - eloLow) / 2.0 << " (95% " << eloLow << " .. " << eloHigh
+              << ")\n"
+              << "sprt elo0=" << options.elo0 << " elo1=" << options.elo1 << " llr " << llr << " [" << lowerBound
+              << ", " << upperBound << "]: "
+              << (llr >= upperBound ? "PASS" : llr <= lowerBound ? "FAIL" : "inconclusive") << std::endl;
+
+    return llr <= lowerBound ? 2 : 0;
+}
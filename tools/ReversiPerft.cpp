@@ -0,0 +1,229 @@
+//
+// ReversiPerft.cpp - move generator check: count the move sequences of every length
+//
+// Usage: reversi_perft [options]
+//   -d DEPTH     deepest count (default 11)
+//   -j THREADS   worker threads (default: all cores)
+//   -m MB        shared table of subtree counts, 0 for none (default 256)
+// Prints the number of leaves at every depth from 1 to DEPTH, starting from
+// the standard position. A pass is a move of its own and a game that ends
+// early counts as one leaf at that depth. Expected counts: 4, 12, 56, 244,
+// 1396, 8200, 55092, 390216, 3005288, 24571284, 212258800, 1939886636,
+// 18429641748, 184042084512.
+//
+
+#include "../headers/Bitboard.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+    struct Options {
+        int depth = 11;
+        int threads = 0;
+        size_t tableMegabytes = 256;
+    };
+
+    // Positions handed out to the workers: the tree is split until there are this many per thread
+    constexpr int TASKS_PER_THREAD = 16;
+
+    // Shallower subtrees are cheaper to count again than to look up
+    constexpr int MIN_STORED_DEPTH = 3;
+
+    /**
+     * Subtree counts keyed by position and depth, shared by every worker
+     * without locks. Each slot keeps the count and its key xor the count, so
+     * a slot half written by one thread while another reads it fails the
+     * check and is treated as a miss. Newer counts always replace older ones.
+     */
+    class CountTable {
+    public:
+        explicit CountTable(const size_t megabytes) {
+            size_t slots = 1;
+            while (slots * 2 * sizeof(Slot) <= megabytes * 1024 * 1024) {
+                slots *= 2;
+            }
+            if (megabytes > 0) {
+                table = std::make_unique<Slot[]>(slots);
+                mask = slots - 1;
+            }
+        }
+
+        bool probe(const uint64_t key, uint64_t &count) const {
+            if (!table) {
+                return false;
+            }
+            const Slot &slot = table[key & mask];
+            count = slot.count.load(std::memory_order_relaxed);
+            return (slot.check.load(std::memory_order_relaxed) ^ count) == key;
+        }
+
+        void store(const uint64_t key, const uint64_t count) {
+            if (!table) {
+                return;
+            }
+            Slot &slot = table[key & mask];
+            slot.check.store(key ^ count, std::memory_order_relaxed);
+            slot.count.store(count, std::memory_order_relaxed);
+        }
+
+    private:
+        struct Slot {
+            std::atomic<uint64_t> check{0};
+            std::atomic<uint64_t> count{0};
+        };
+
+        std::unique_ptr<Slot[]> table;
+        size_t mask = 0;
+    };
+
+    // Table key of a subtree: the position hash with the depth mixed in
+    uint64_t subtreeKey(const Position &pos, const int depth) {
+        return Bitboard::hash(pos) ^ (static_cast<uint64_t>(depth) * 0x9E3779B97F4A7C15ULL);
+    }
+
+    uint64_t perft(const Position &pos, const int depth, CountTable &table) {
+        if (depth == 0) {
+            return 1;
+        }
+
+        uint64_t moves = Bitboard::getMoves(pos.player, pos.opponent);
+        if (!moves) {
+            if (!Bitboard::getMoves(pos.opponent, pos.player)) {
+                return 1;
+            }
+            return perft(Bitboard::pass(pos), depth - 1, table);
+        }
+        if (depth == 1) {
+            return Bitboard::popcount(moves);
+        }
+
+        const uint64_t key = subtreeKey(pos, depth);
+        uint64_t count;
+        if (depth >= MIN_STORED_DEPTH && table.probe(key, count)) {
+            return count;
+        }
+
+        count = 0;
+        while (moves) {
+            const int square = Bitboard::lowestSquare(moves);
+            moves &= moves - 1;
+            count += perft(Bitboard::play(pos, square, Bitboard::getFlips(pos.player, pos.opponent, square)),
+                           depth - 1, table);
+        }
+
+        if (depth >= MIN_STORED_DEPTH) {
+            table.store(key, count);
+        }
+        return count;
+    }
+
+    // A subtree left for the workers: its position and the depth still to count
+    struct Task {
+        Position pos;
+        int depth;
+    };
+
+    /**
+     * Split the tree level by level until there are enough subtrees to keep
+     * every worker busy; the root has only four moves. Leaves met on the way
+     * are counted directly.
+     */
+    std::vector<Task> split(const Position &root, const int depth, const size_t wanted, uint64_t &counted) {
+        std::vector<Task> tasks{{root, depth}};
+
+        while (tasks.size() < wanted) {
+            std::vector<Task> next;
+            bool expanded = false;
+            for (const Task &task: tasks) {
+                uint64_t moves = Bitboard::getMoves(task.pos.player, task.pos.opponent);
+                if (task.depth <= MIN_STORED_DEPTH) {
+                    next.push_back(task);
+                } else if (!moves) {
+                    if (Bitboard::getMoves(task.pos.opponent, task.pos.player)) {
+                        next.push_back({Bitboard::pass(task.pos), task.depth - 1});
+                        expanded = true;
+                    } else {
+                        counted++;
+                    }
+                } else {
+                    while (moves) {
+                        const int square = Bitboard::lowestSquare(moves);
+                        moves &= moves - 1;
+                        const uint64_t flips = Bitboard::getFlips(task.pos.player, task.pos.opponent, square);
+                        next.push_back({Bitboard::play(task.pos, square, flips), task.depth - 1});
+                    }
+                    expanded = true;
+                }
+            }
+            tasks.swap(next);
+            if (!expanded) {
+                break;
+            }
+        }
+        return tasks;
+    }
+
+    uint64_t parallelPerft(const Position &root, const int depth, const int threads, CountTable &table) {
+        uint64_t counted = 0;
+        const std::vector<Task> tasks = split(root, depth, static_cast<size_t>(threads) * TASKS_PER_THREAD, counted);
+
+        std::atomic<size_t> nextTask{0};
+        std::atomic<uint64_t> total{counted};
+        std::vector<std::thread> workers;
+        for (int t = 0; t < threads; t++) {
+            workers.emplace_back([&]() {
+                uint64_t sum = 0;
+                for (size_t i = nextTask++; i < tasks.size(); i = nextTask++) {
+                    sum += perft(tasks[i].pos, tasks[i].depth, table);
+                }
+                total += sum;
+            });
+        }
+        for (std::thread &worker: workers) {
+            worker.join();
+        }
+        return total;
+    }
+}
+
+int main(int argc, char *argv[]) {
+    Options options;
+
+    for (int i = 1; i < argc; i++) {
+        const std::string arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+
+        if (arg == "-d" && hasValue) {
+            options.depth = std::stoi(argv[++i]);
+        } else if (arg == "-j" && hasValue) {
+            options.threads = std::stoi(argv[++i]);
+        } else if (arg == "-m" && hasValue) {
+            options.tableMegabytes = std::stoul(argv[++i]);
+        } else {
+            std::cerr << "Usage: reversi_perft [-d depth] [-j threads] [-m MB]" << std::endl;
+            return 1;
+        }
+    }
+
+    int threads = options.threads > 0 ? options.threads : static_cast<int>(std::thread::hardware_concurrency());
+    threads = std::max(1, threads);
+
+    CountTable table(options.tableMegabytes);
+    const Position root = Bitboard::initial();
+
+    std::cout << "perft with " << threads << " threads, " << options.tableMegabytes << " MB table" << std::endl;
+    for (int depth = 1; depth <= options.depth; depth++) {
+        const auto start = std::chrono::steady_clock::now();
+        const uint64_t count = parallelPerft(root, depth, threads, table);
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cout << "depth " << depth << ": " << count << " (" << seconds << " s)" << std::endl;
+    }
+    return 0;
+}
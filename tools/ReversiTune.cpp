@@ -0,0 +1,330 @@
+//
+// ReversiTune.cpp - fit the evaluation weights to the results of finished games
+//
+// Usage: reversi_tune [options] [TRAINING_FILE...]
+//   -g FILE      transcript file, one finished game per line (see Transcript.h),
+//                or a game file written by reversi_datagen -g
+//   -o FILE      weights file to write (default reversi.eval)
+//   -i FILE      start from these weights instead of the built-in ones
+//   -n EPOCHS    gradient steps over the whole set (default 500)
+//   -l RATE      Adam learning rate in evaluation units (default 0.1)
+//   -r LAMBDA    L2 penalty on the square class weights (default 1e-6)
+//   -k K         logistic scale; fitted to the starting weights when omitted
+//   -j THREADS   worker threads (default: all cores)
+// Positions come from reversi_datagen files and transcripts. Each one is
+// labelled with its game's result from the side to move (win 1, draw 0.5,
+// loss 0). The weights minimise the mean squared error of sigmoid(K * eval)
+// against those labels. Copy the output to weights/reversi.eval to use it
+// in the game.
+//
+
+#include "../headers/Bitboard.h"
+#include "../headers/Compact.h"
+#include "../headers/Evaluation.h"
+#include "../headers/Search.h"
+#include "../headers/TrainingData.h"
+#include "../headers/Transcript.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+    struct Options {
+        std::vector<std::string> trainingFiles;
+        std::vector<std::string> gameFiles;
+        std::string output = "reversi.eval";
+        std::string initial;
+        int epochs = 500;
+        double rate = 0.1;
+        double lambda = 1e-6;
+        double k = 0.0;
+        int threads = 0;
+    };
+
+    // One position reduced to what the loss needs: every feature is linear in the weights
+    struct Sample {
+        int8_t features[Evaluation::FEATURES];
+        float result;
+    };
+
+    // Sum over one thread's share of the samples
+    struct Partial {
+        double loss = 0.0;
+        double gradient[Evaluation::FEATURES] = {};
+    };
+
+    Sample makeSample(const Position &pos, const int finalScore) {
+        int features[Evaluation::FEATURES];
+        Evaluation::features(pos, features);
+
+        Sample sample{};
+        for (int feature = 0; feature < Evaluation::FEATURES; feature++) {
+            sample.features[feature] = static_cast<int8_t>(features[feature]);
+        }
+        sample.result = finalScore > 0 ? 1.0f : finalScore < 0 ? 0.0f : 0.5f;
+        return sample;
+    }
+
+    // Label every position of a game with its result; unfinished games are skipped
+    void addGame(const GameLine &game, std::vector<Sample> &samples) {
+        const Position &last = game.finalPosition;
+        if (Bitboard::getMoves(last.player, last.opponent) || Bitboard::getMoves(last.opponent, last.player)) {
+            return;
+        }
+
+        const int result = Search::discDifference(Search::finalScore(last));
+        const int whiteResult = game.finalWhiteToMove ? result : -result;
+        for (size_t i = 0; i < game.positions.size(); i++) {
+            samples.push_back(makeSample(game.positions[i], game.whiteToMove[i] ? whiteResult : -whiteResult));
+        }
+    }
+
+    bool readGames(const std::string &path, std::vector<Sample> &samples) {
+        std::ifstream file(path, std::ios::binary);
+        if (!file.is_open()) {
+            return false;
+        }
+
+        // Packed game files from reversi_datagen -g
+        if (Compact::readGamesHeader(file)) {
+            std::vector<int> moves;
+            int gameNumber = 0;
+            while (Compact::readGame(file, moves)) {
+                gameNumber++;
+                GameLine game;
+                std::string error;
+                if (!Transcript::replay(moves, game, error)) {
+                    std::cerr << path << ": game " << gameNumber << ": " << error << std::endl;
+                    continue;
+                }
+                addGame(game, samples);
+            }
+            return true;
+        }
+
+        std::string line;
+        int lineNumber = 0;
+        while (std::getline(file, line)) {
+            lineNumber++;
+            GameLine game;
+            std::string error;
+            if (line.empty() || !Transcript::parse(line, game, error)) {
+                if (!line.empty()) {
+                    std::cerr << path << ":" << lineNumber << ": " << error << std::endl;
+                }
+                continue;
+            }
+            addGame(game, samples);
+        }
+        return true;
+    }
+
+    double sigmoid(const double x) {
+        return 1.0 / (1.0 + std::exp(-x));
+    }
+
+    /**
+     * Loss and gradient of `weights` over every sample. Each thread sums its own
+     * slice into a Partial; the partials are added at the end, so no thread
+     * ever writes to shared state.
+     */
+    Partial evaluateSet(const std::vector<Sample> &samples, const double weights[], const double k,
+                        const int threads) {
+        std::vector<Partial> partials(threads);
+        std::vector<std::thread> workers;
+        const size_t chunk = (samples.size() + threads - 1) / threads;
+
+        for (int t = 0; t < threads; t++) {
+            workers.emplace_back([&, t]() {
+                Partial &partial = partials[t];
+                const size_t begin = std::min(samples.size(), t * chunk);
+                const size_t end = std::min(samples.size(), begin + chunk);
+
+                for (size_t i = begin; i < end; i++) {
+                    const Sample &sample = samples[i];
+                    double eval = 0.0;
+                    for (int feature = 0; feature < Evaluation::FEATURES; feature++) {
+                        eval += weights[feature] * sample.features[feature];
+                    }
+
+                    const double predicted = sigmoid(k * eval);
+                    const double error = predicted - sample.result;
+                    partial.loss += error * error;
+
+                    const double slope = 2.0 * error * predicted * (1.0 - predicted) * k;
+                    for (int feature = 0; feature < Evaluation::FEATURES; feature++) {
+                        partial.gradient[feature] += slope * sample.features[feature];
+                    }
+                }
+            });
+        }
+        for (std::thread &worker: workers) {
+            worker.join();
+        }
+
+        Partial total;
+        for (const Partial &partial: partials) {
+            total.loss += partial.loss;
+            for (int feature = 0; feature < Evaluation::FEATURES; feature++) {
+                total.gradient[feature] += partial.gradient[feature];
+            }
+        }
+
+        const double count = static_cast<double>(std::max<size_t>(1, samples.size()));
+        total.loss /= count;
+        for (double &gradient: total.gradient) {
+            gradient /= count;
+        }
+        return total;
+    }
+
+    // K that best maps the starting evaluation onto results, by golden-section search on log K
+    double fitK(const std::vector<Sample> &samples, const double weights[], const int threads) {
+        const double ratio = (std::sqrt(5.0) - 1.0) / 2.0;
+        double low = std::log(1e-4);
+        double high = std::log(1.0);
+
+        for (int step = 0; step < 40; step++) {
+            const double a = high - ratio * (high - low);
+            const double b = low + ratio * (high - low);
+            if (evaluateSet(samples, weights, std::exp(a), threads).loss
+                < evaluateSet(samples, weights, std::exp(b), threads).loss) {
+                high = b;
+            } else {
+                low = a;
+            }
+        }
+        return std::exp((low + high) / 2.0);
+    }
+}
+
+int main(int argc, char *argv[]) {
+    Options options;
+
+    for (int i = 1; i < argc; i++) {
+        const std::string arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+
+        if (arg == "-g" && hasValue) {
+            options.gameFiles.emplace_back(argv[++i]);
+        } else if (arg == "-o" && hasValue) {
+            options.output = argv[++i];
+        } else if (arg == "-i" && hasValue) {
+            options.initial = argv[++i];
+        } else if (arg == "-n" && hasValue) {
+            options.epochs = std::stoi(argv[++i]);
+        } else if (arg == "-l" && hasValue) {
+            options.rate = std::stod(argv[++i]);
+        } else if (arg == "-r" && hasValue) {
+            options.lambda = std::stod(argv[++i]);
+        } else if (arg == "-k" && hasValue) {
+            options.k = std::stod(argv[++i]);
+        } else if (arg == "-j" && hasValue) {
+            options.threads = std::stoi(argv[++i]);
+        } else if (!arg.empty() && arg[0] != '-') {
+            options.trainingFiles.push_back(arg);
+        } else {
+            std::cerr << "Usage: reversi_tune [-g games.txt] [-o file] [-i file] [-n epochs] [-l rate] [-r lambda]"
+                         " [-k K] [-j threads] [training.bin...]" << std::endl;
+            return 1;
+        }
+    }
+
+    std::vector<Sample> samples;
+    for (const std::string &path: options.trainingFiles) {
+        std::vector<TrainingRecord> records;
+        if (!TrainingData::read(path, records)) {
+            std::cerr << "Can't read training file " << path << std::endl;
+            return 1;
+        }
+        for (const TrainingRecord &record: records) {
+            samples.push_back(makeSample({record.player, record.opponent}, record.finalScore));
+        }
+    }
+    for (const std::string &path: options.gameFiles) {
+        if (!readGames(path, samples)) {
+            std::cerr << "Can't read games file " << path << std::endl;
+            return 1;
+        }
+    }
+    if (samples.empty()) {
+        std::cerr << "No positions to tune on" << std::endl;
+        return 1;
+    }
+
+    Evaluation::Weights start;
+    if (!options.initial.empty() && !Evaluation::load(options.initial, start)) {
+        std::cerr << "Can't read weights file " << options.initial << std::endl;
+        return 1;
+    }
+
+    int threads = options.threads > 0 ? options.threads : static_cast<int>(std::thread::hardware_concurrency());
+    threads = std::max(1, threads);
+
+    double weights[Evaluation::FEATURES];
+    for (int feature = 0; feature < Evaluation::FEATURES; feature++) {
+        weights[feature] = start.values[feature];
+    }
+
+    const auto startTime = std::chrono::steady_clock::now();
+    const double k = options.k > 0.0 ? options.k : fitK(samples, weights, threads);
+    std::cout << samples.size() << " positions, K = " << k << ", starting loss "
+              << evaluateSet(samples, weights, k, threads).loss << std::endl;
+
+    // Adam over the full set; the square classes overlap the other features, so they are kept small
+    constexpr double BETA1 = 0.9;
+    constexpr double BETA2 = 0.999;
+    constexpr double EPSILON = 1e-12;
+    double moment[Evaluation::FEATURES] = {};
+    double velocity[Evaluation::FEATURES] = {};
+
+    for (int epoch = 1; epoch <= options.epochs; epoch++) {
+        Partial step = evaluateSet(samples, weights, k, threads);
+        for (int feature = Evaluation::SQUARE_CLASS; feature < Evaluation::FEATURES; feature++) {
+            step.loss += options.lambda * weights[feature] * weights[feature];
+            step.gradient[feature] += 2.0 * options.lambda * weights[feature];
+        }
+
+        for (int feature = 0; feature < Evaluation::FEATURES; feature++) {
+            const double gradient = step.gradient[feature];
+            moment[feature] = BETA1 * moment[feature] + (1.0 - BETA1) * gradient;
+            velocity[feature] = BETA2 * velocity[feature] + (1.0 - BETA2) * gradient * gradient;
+
+            const double momentHat = moment[feature] / (1.0 - std::pow(BETA1, epoch));
+            const double velocityHat = velocity[feature] / (1.0 - std::pow(BETA2, epoch));
+            weights[feature] -= options.rate * momentHat / (std::sqrt(velocityHat) + EPSILON);
+        }
+
+        if (epoch % 50 == 0 || epoch == options.epochs) {
+            std::cerr << "epoch " << epoch << " loss " << step.loss << std::endl;
+        }
+    }
+
+    // The search evaluates in whole units
+    Evaluation::Weights tuned;
+    for (int feature = 0; feature < Evaluation::FEATURES; feature++) {
+        tuned.values[feature] = static_cast<int>(std::lround(weights[feature]));
+    }
+
+    double roundedWeights[Evaluation::FEATURES];
+    for (int feature = 0; feature < Evaluation::FEATURES; feature++) {
+        roundedWeights[feature] = tuned.values[feature];
+        std::cout << Evaluation::featureName(feature) << ' ' << tuned.values[feature] << std::endl;
+    }
+
+    if (!Evaluation::save(options.output, tuned)) {
+        std::cerr << "Can't write " << options.output << std::endl;
+        return 1;
+    }
+
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    std::cout << "final loss " << evaluateSet(samples, roundedWeights, k, threads).loss << " in " << seconds
+              << " s (" << threads << " threads) -> " << options.output << std::endl;
+    return 0;
+}
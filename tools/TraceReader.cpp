@@ -0,0 +1,124 @@
+//
+// TraceReader.cpp - aggregates a binary search trace written by SearchTrace
+//
+// Usage: reversi_trace_reader [trace file]
+//
+
+#include "../headers/SearchTrace.h"
+
+#include <cstdio>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <vector>
+
+namespace {
+    constexpr int MAX_DEPTH = 64;
+    constexpr int MAX_INDEX = 32;
+
+    struct DepthStats {
+        uint64_t nodes = 0;
+        uint64_t cutoffs = 0;
+        uint64_t ttProbes = 0;
+        uint64_t ttHits = 0;
+        uint64_t cutoffIndex[MAX_INDEX + 1] = {};   // last bucket collects everything later
+    };
+}
+
+int main(int argc, char *argv[]) {
+    const char *path = argc > 1 ? argv[1] : "search_trace.bin";
+
+    FILE *file = fopen(path, "rb");
+    if (!file) {
+        std::cerr << "Can't open trace file: " << path << std::endl;
+        return 1;
+    }
+
+    char magic[sizeof(TRACE_MAGIC)];
+    uint32_t header[2];
+    if (fread(magic, 1, sizeof(magic), file) != sizeof(magic) ||
+        fread(header, sizeof(uint32_t), 2, file) != 2 ||
+        std::memcmp(magic, TRACE_MAGIC, sizeof(magic)) != 0 ||
+        header[0] != TRACE_VERSION || header[1] != sizeof(TraceEvent)) {
+        std::cerr << "Not a search trace (or unsupported version): " << path << std::endl;
+        fclose(file);
+        return 1;
+    }
+
+    std::vector<DepthStats> depths(MAX_DEPTH);
+    std::map<int, uint64_t> threadEvents;
+    uint64_t totalEvents = 0;
+
+    std::vector<TraceEvent> chunk(1 << 16);
+    size_t read;
+    while ((read = fread(chunk.data(), sizeof(TraceEvent), chunk.size(), file)) > 0) {
+        for (size_t i = 0; i < read; i++) {
+            const TraceEvent &event = chunk[i];
+            DepthStats &stats = depths[event.depth < MAX_DEPTH ? event.depth : MAX_DEPTH - 1];
+            totalEvents++;
+            threadEvents[event.thread]++;
+
+            switch (static_cast<TraceEventType>(event.type)) {
+                case TraceEventType::NODE_ENTER:
+                    stats.nodes++;
+                    break;
+                case TraceEventType::CUTOFF:
+                    stats.cutoffs++;
+                    stats.cutoffIndex[event.moveIndex < MAX_INDEX ? event.moveIndex : MAX_INDEX]++;
+                    break;
+                case TraceEventType::TT_PROBE:
+                    stats.ttProbes++;
+                    break;
+                case TraceEventType::TT_HIT:
+                    stats.ttProbes++;
+                    stats.ttHits++;
+                    break;
+                default:
+                    break;
+            }
+        }
+    }
+    fclose(file);
+
+    std::cout << "Trace: " << path << '\n'
+              << "Events: " << totalEvents << " from " << threadEvents.size() << " thread(s)\n\n";
+
+    // Per-depth summary
+    std::cout << "depth        nodes      cutoffs  first-move%     tt-probes   tt-hit%\n";
+    for (int d = MAX_DEPTH - 1; d >= 0; d--) {
+        const DepthStats &stats = depths[d];
+        if (stats.nodes == 0 && stats.cutoffs == 0 && stats.ttProbes == 0) {
+            continue;
+        }
+        const double firstMove = stats.cutoffs ? 100.0 * stats.cutoffIndex[0] / stats.cutoffs : 0.0;
+        const double hitRate = stats.ttProbes ? 100.0 * stats.ttHits / stats.ttProbes : 0.0;
+        std::cout << std::setw(5) << d
+                  << std::setw(13) << stats.nodes
+                  << std::setw(13) << stats.cutoffs
+                  << std::setw(13) << std::fixed << std::setprecision(1) << firstMove
+                  << std::setw(14) << stats.ttProbes
+                  << std::setw(10) << hitRate << '\n';
+    }
+
+    // Cutoff position histogram by depth
+    std::cout << "\nCutoff move-index histogram (% of cutoffs at that depth)\n";
+    for (int d = MAX_DEPTH - 1; d >= 0; d--) {
+        const DepthStats &stats = depths[d];
+        if (stats.cutoffs == 0) {
+            continue;
+        }
+        std::cout << "depth " << std::setw(2) << d << ':';
+        int last = MAX_INDEX;
+        while (last > 0 && stats.cutoffIndex[last] == 0) {
+            last--;
+        }
+        for (int i = 0; i <= last; i++) {
+            std::cout << ' ' << (i == MAX_INDEX ? ">=" : "") << i << '='
+                      << std::setprecision(1) << 100.0 * stats.cutoffIndex[i] / stats.cutoffs;
+        }
+        std::cout << '\n';
+    }
+
+    return 0;
+}